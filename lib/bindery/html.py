@@ -8,6 +8,7 @@ __all__ = [
 'Document', 'Doctype', 'Comment', 'Element',
 ]
 
+import sys
 import copy
 import itertools
 from functools import *
@@ -26,11 +27,24 @@ class node(html5lib.treebuilders._base.Node):
     parent = tree.node.xml_parent
     value = tree.text.xml_value
 
+    def __nonzero__(self):
+        #html5lib tests nodes for truth meaning "is not None", which would
+        #otherwise count same-named siblings via bindery's __len__
+        return True
+
     def insertText(self, data, insertBefore=None):
         """Insert data as text in the current node, positioned before the 
         start of node insertBefore or to the end of the node's text.
         """
-        if insertBefore:
+        #html5lib delivers text in many small pieces, so extend an adjacent
+        #text node rather than creating a new one for each
+        if insertBefore is not None:
+            previous = insertBefore.xml_preceding_sibling
+        else:
+            previous = self.xml_last_child
+        if isinstance(previous, tree.text):
+            previous.xml_value += data
+        elif insertBefore is not None:
             self.insertBefore(tree.text(data), insertBefore)
         else:
             self.xml_append(tree.text(data))
@@ -39,8 +53,17 @@ class node(html5lib.treebuilders._base.Node):
         """Insert node as a child of the current node, before refNode in the 
         list of child nodes. Raises ValueError if refNode is not a child of 
         the current node"""
-        offset = self.xml_index(refNode)
-        self.xml_insert(offset, node)
+        #refNode is a table being foster parented around, normally the last child
+        if refNode is self.xml_last_child:
+            self.xml_insert(-1, node)
+        else:
+            self.xml_insert(self.xml_index(refNode), node)
+
+    def reparentChildren(self, newParent):
+        """Move all the children of the current node to newParent. 
+        """
+        #Moved in bulk; they are detached from this node all at once
+        newParent.xml_splice(sys.maxint, sys.maxint, self.xml_children)
 
     def cloneNode(self):
         """Return a shallow copy of the current node i.e. a node with the same
@@ -51,7 +74,20 @@ class node(html5lib.treebuilders._base.Node):
     def hasContent(self):
         """Return true if the node has children or text, false otherwise
         """
-        return bool(list(self.xml_children))
+        return self.xml_first_child is not None
+
+
+class _lazy_flags(object):
+    """
+    html5lib's miscellaneous flags for a node, only allocated for the few
+    nodes (tables) that set any
+    """
+    def __get__(self, obj, owner):
+        if obj is None:
+            return self
+        #The instance attribute takes precedence from now on
+        flags = obj._flags = []
+        return flags
 
 
 class element(nodes.element_base, node):
@@ -83,17 +119,11 @@ class element(nodes.element_base, node):
         return self.xml_children
 
     def xml_set_childNodes_(self, l):
-        #No self.xml_clear() ...
-        for child in self.xml_children:
-            self.xml_remove(child)
-        for i in l: self.xml_append(i)
+        self.xml_splice(0, sys.maxint, l)
         return
 
     childNodes = property(xml_get_childNodes_, xml_set_childNodes_, None, "html5lib uses this property to manage HTML element children")
-    def __init__(self, ns, qname):
-        nodes.element_base.__init__(self, ns, qname)
-        self._flags = []
-        return
+    _flags = _lazy_flags()
 
     def xml_set_attributes_(self, attrs):
         for key, val in attrs.iteritems():
@@ -39,7 +39,7 @@ from amara import tree
 from amara.lib.xmlstring import U
 from amara.lib.util import element_subtree_iter
 from amara.xpath import datatypes
-from amara.xpath.util import named_node_test, abspath
+from amara.xpath.util import named_node_test, abspath, top_namespaces
 from amara.bindery import BinderyError
 from amara.namespaces import AKARA_NAMESPACE
 from amara.xpath import context, parser
@@ -50,31 +50,60 @@ NODE_ID_MARKER = u'generate-id()'
 class constraint(object):
     '''
     Represents a constraint on an XML model
+
+    assertion - an XPath expression which must be true for the node, or a
+                callable returning one (given the node)
+    fixup - optional callable given the node, to try to make a failed
+            assertion true
+    msg - optional message used when the constraint fails
+    incremental - true if the assertion only depends upon the attributes
+                  and child nodes of the node, so it need not be checked
+                  again while those are unchanged (see content_model.validate)
     '''
-    def __init__(self, assertion, fixup=None, msg=None):
+    def __init__(self, assertion, fixup=None, msg=None, incremental=False):
         self.assertion = assertion
         self.fixup = fixup
         self.msg = msg
-    
+        self.incremental = incremental
+        #Parsed assertions, keyed by the XPath expression string
+        self._compiled = {}
+
+    def compile(self, assertion):
+        '''
+        Return the parsed form of an XPath assertion string, parsing it only once
+        '''
+        try:
+            return self._compiled[assertion]
+        except KeyError:
+            expr = self._compiled[assertion] = parser.parse(assertion)
+            return expr
+
     def validate(self, node):
         '''
         Check this constraint against a node.
         Raise an exception if the constraint fails, possibly after attempting fixup
         '''
-        from amara.bindery import BinderyError
         assertion = self.assertion
         if callable(assertion):
             assertion = assertion(node)
-        result = datatypes.boolean(node.xml_select(assertion))
-        if not result:
+        expr = self.compile(assertion)
+        if not _evaluate_as_boolean(expr, node):
             if self.fixup:
                 self.fixup(node)
-                result = datatypes.string(node.xml_select(assertion))
-                if result:
+                if _evaluate_as_boolean(expr, node):
                     return
             raise BinderyError(BinderyError.CONSTRAINT_VIOLATION, constraint=self.msg or assertion, node=abspath(node))
 
 
+def _evaluate_as_boolean(expr, node):
+    #Same context as node.xml_select(expr) would use
+    try:
+        prefixes = dict(node.xml_namespaces.iteritems())
+    except AttributeError:
+        prefixes = top_namespaces(node.xml_root)
+    return datatypes.boolean(expr.evaluate(context(node, 0, 0, namespaces=prefixes)))
+
+
 class attribute_constraint(constraint):
     '''
     Constraint representing the presence of an attribute on an element
@@ -84,7 +113,7 @@ class attribute_constraint(constraint):
         self.local = local
         self.default = default
         assertion = self.assertion if self.ns else u'@' + self.local
-        constraint.__init__(self, assertion, fixup=(self.set_default if default else None))
+        constraint.__init__(self, assertion, fixup=(self.set_default if default else None), incremental=True)
 
     def set_default(self, node):
         node.xml_attributes[self.ns, self.local] = self.default
@@ -104,7 +133,7 @@ class child_element_constraint(constraint):
         self.local = local
         self.default = default
         assertion = partial(named_node_test, self.ns, self.local) if self.ns else self.local
-        constraint.__init__(self, assertion, fixup=(self.set_default if default else None))
+        constraint.__init__(self, assertion, fixup=(self.set_default if default else None), incremental=True)
 
     def set_default(self, node):
         #XXX: Should be able to reuse named_node_test function
@@ -139,6 +168,8 @@ class content_model:
         self.metadata_context_expr = None
         self.other_rel_exprs = []
         self.prefixes = {}
+        #{element: (signature, number of constraints checked)}
+        self._validated = {}
         return
 
     def add_constraint(self, constraint, validate=False):
@@ -147,22 +178,45 @@ class content_model:
         return
 
     def validate(self, node=None):
-        #print repr(node)
+        '''
+        Check the constraints against a node, or against every element of
+        this model in all of its entities if no node is given.
+
+        Validation is incremental: constraints marked as incremental are only
+        checked again for an element if its child nodes or attributes have
+        changed since it was last validated (or if they were added since).
+        '''
         #re-validate all constraints, not just this one (interlocking constraints will likely be coming in future)
-        if node:
-            #Check all constraints
-            for constraint in self.constraints:
-                constraint.validate(node)
+        if node is not None:
+            constraints = self.constraints
+            start = len(constraints)
+            if constraints:
+                #Skip the constraints already checked, if node is unchanged since
+                checked = self._validated.get(node)
+                if checked and checked[1] <= start and checked[0] == _signature(node):
+                    start = checked[1]
+                else:
+                    start = 0
+            for index, constraint in enumerate(constraints):
+                if index >= start or not constraint.incremental:
+                    constraint.validate(node)
+            if start < len(constraints):
+                #Fixups might have changed the node
+                self._validated[node] = (_signature(node), len(constraints))
             #Make sure all known element types have corresponding properties on the node class
             for (ns, local), (pname, default) in self.element_types.iteritems():
                 if not hasattr(node, pname):
                     from amara.bindery.nodes import node
                     setattr(node.__class__, pname, bound_element(ns, local))
         else:
+            #Start over, forgetting about elements no longer in the entities
+            validated, self._validated = self._validated, {}
             for d in self.entities:
                 subtree = element_subtree_iter(d, include_root=True)
                 for e in subtree:
                     if e.xml_model == self:
+                        checked = validated.get(e)
+                        if checked: self._validated[e] = checked
                         self.validate(e)
         return
 
@@ -234,6 +288,12 @@ class content_model:
             return ( item for item in handle_element(root, root.xml_base) )
 
 
+def _signature(node):
+    #Identifies the state of the child nodes and attributes of an element
+    attributes = getattr(node, 'xml_attributes', None)
+    return (tuple(node.xml_children), tuple(attributes.items()) if attributes else ())
+
+
 #        node.xml_model.constraints.append(u'@xml:id', validate=True)      #Make xml:id required.  Will throw a constraint violation right away if there is not one.  Affects all instances of this class.
 #        node.xml_model.validate(recurse=True)     #Recursively validate constraints on node and all children
 
@@ -62,7 +62,7 @@ class examplotron_model(document_model):
                 parent.xml_model.add_constraint(c)
             if not eg_occurs in [u'+', u'*']:
                 parent.xml_model.add_constraint(
-                    constraint(u'count(%s) = 1'%named_node_test(e.xml_namespace, e.xml_local, parent), msg=u'Only one instance of element allowed')
+                    constraint(u'count(%s) = 1'%named_node_test(e.xml_namespace, e.xml_local, parent), msg=u'Only one instance of element allowed', incremental=True)
                 )
             allowed_elements_test.append(named_node_test(e.xml_namespace, e.xml_local, parent))
 
@@ -127,11 +127,11 @@ class examplotron_model(document_model):
 
         if allowed_elements_test:
             parent.xml_model.add_constraint(
-                constraint(u'count(%s) = count(*)'%u'|'.join(allowed_elements_test), msg=u'Invalid elements present')
+                constraint(u'count(%s) = count(*)'%u'|'.join(allowed_elements_test), msg=u'Invalid elements present', incremental=True)
             )
         else:
             parent.xml_model.add_constraint(
-                constraint(u'not(*)', msg=u'Element should be empty')
+                constraint(u'not(*)', msg=u'Element should be empty', incremental=True)
             )
         #To do:
         #Add <ak:product ak:name="AVT" ak:value="AVT"/>
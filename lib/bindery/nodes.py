@@ -288,6 +288,20 @@ class container_mixin(object):
         #Nothing really to do: we don't want to remove the descriptor from the class, since other instances might be using it
         return
 
+    def xml_children_spliced(self, removed, inserted):
+        """
+        called after xml_splice has removed and/or inserted several children at once
+        """
+        #Nothing to do for removed children (see xml_child_removed); register each element name only once
+        names = set()
+        for child in inserted:
+            if isinstance(child, tree.element):
+                name = child.xml_namespace, child.xml_local
+                if name not in names:
+                    names.add(name)
+                    self.xml_new_pname_mapping(name[0], name[1], True)
+        return
+
     def xml_find_named_child(self, ns, local, childiter=None):
         #This function is very heavily used, and should be carefully optimized
         found = False
@@ -324,8 +338,8 @@ class container_mixin(object):
     def xml_append_fragment(self, frag):
         from amara.bindery import parse
         doc = parse(frag)
-        for child in doc.xml_children:
-            self.xml_append(child)
+        offset = len(self.xml_children)
+        self.xml_splice(offset, offset, doc.xml_children)
         return
 
     def __getitem__(self, key):
@@ -490,12 +504,8 @@ class container_mixin(object):
             self.xml_remove(target)
             self.xml_insert(offset, target)
             return
-        children = []
-        for child in self.xml_children:
-            self.xml_remove(child)
-            children.append(child)
-        for child in children:
-            self.xml_append(child)
+        children = self.xml_children
+        self.xml_splice(0, len(children), children)
         return
 
 
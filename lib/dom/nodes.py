@@ -87,15 +87,24 @@ class _container(Node):
     @property
     def nextSibling(self): return self.xml_following_sibling
 
-    def hasChildNodes(self): return bool(self.xml_children)
+    def hasChildNodes(self): return self.xml_first_child is not None
     #Don't just assign the functions since there are subtle differences we'll need to fix up
     def appendChild(self, node): return self.xml_append(node)
     def replaceChild(self, newChild, oldChild): return self.xml_replace(oldChild, newChild)
     def removeChild(self, node): return self.xml_remove(node)
     def insertBefore(self, newChild, refNode):
-        index = self.xml_index(refChild)
+        if refNode is None:
+            return self.xml_append(newChild)
+        index = self.xml_index(refNode)
         return self.xml_insert(index, newChild)
-    def getElementsByTagNameNS(self, namespaceURI, localName): return ( e for e in self.xml_select(u'//*') if (e.xml_namespace, e.xml_local) == (namespaceURI, localName))
+    def getElementsByTagNameNS(self, namespaceURI, localName):
+        return iter(tree.elements_by_name(self, namespaceURI, localName))
+    def getElementsByTagName(self, tagName):
+        if tagName == u'*':
+            return iter(tree.elements_by_name(self, u'*', u'*'))
+        prefix, local = splitqname(tagName)
+        return ( e for e in tree.elements_by_name(self, u'*', local)
+                 if e.xml_qname == tagName )
 
 
 class DocumentFragment(_container, tree.entity):
@@ -336,6 +345,10 @@ class Document(_container, tree.entity):
     strictErrorChecking = False
     errorHandler = None
     documentURI = None
+    # (namespace, local) -> elements, built on demand and discarded once
+    # the tree changes (see getElementsByTagNameNS)
+    _element_index = None
+    _element_index_stamp = None
 
     def xml_comment_factory(self, data):
         node = Comment(data)
@@ -400,9 +413,8 @@ class Document(_container, tree.entity):
         return a
 
     def createElementNS(self, namespaceURI, qualifiedName):
-        prefix, localName = splitqname(qualifiedName)
-        e = Element(qualifiedName, namespaceURI, prefix)
-        e.ownerDocument = self
+        e = Element(namespaceURI, qualifiedName)
+        e._set_ownerdoc(self)
         return e
 
     def createAttributeNS(self, namespaceURI, qualifiedName):
@@ -427,8 +439,19 @@ class Document(_container, tree.entity):
 
     @property
     def documentElement(self):
-        child_elements = [ ch for ch in self.xml_children if isinstance(ch, tree.element) ]
-        return child_elements[0] if child_elements else None
+        for child in self.xml_children:
+            if isinstance(child, tree.element):
+                return child
+        return None
+
+    def getElementsByTagNameNS(self, namespaceURI, localName):
+        if namespaceURI == u'*' or localName == u'*':
+            return iter(tree.elements_by_name(self, namespaceURI, localName))
+        stamp = tree.mutation_count()
+        if stamp != self._element_index_stamp:
+            self._element_index = tree.element_index(self)
+            self._element_index_stamp = stamp
+        return iter(self._element_index.get((namespaceURI or None, localName), ()))
 
     def importNode(self, node, deep):
         if node.nodeType == stdlib_node.DOCUMENT_NODE:
@@ -96,7 +96,10 @@ class _inputsource(InputSource):
     def __init__(self, arg, uri=None, encoding=None, resolver=None, sourcetype=0):
         #uri is set 
         from amara.lib.irihelpers import DEFAULT_RESOLVER
-        self.resolver = resolver or DEFAULT_RESOLVER
+        #__new__ passes existing input sources through unchanged; don't let
+        #the re-initialization discard the resolver they were created with
+        if resolver is not None or not hasattr(self, 'resolver'):
+            self.resolver = resolver or DEFAULT_RESOLVER
 
     @staticmethod
     def text(arg, uri=None, encoding=None, resolver=None):
@@ -121,7 +124,9 @@ class _inputsource(InputSource):
         """
         if baseUri:
             uriRef = self.resolver.absolutize(uriRef, baseUri)
-        return self.__class__(uriRef)
+        # Resources referenced from this one (external entities, XIncludes)
+        # are retrieved through the same resolver
+        return self.__class__(uriRef, resolver=self.resolver)
 
     def absolutize(self, uriRef, baseUri):
         """
@@ -41,6 +41,9 @@ from email.Utils import formatdate as _formatdate
 from uuid import UUID, uuid1, uuid4
 
 from amara.lib import IriError, importutil
+from amara.lib._iri import split_uri_ref, remove_dot_segments
+from amara.lib._iri import get_scheme, is_absolute
+from amara.lib._iri import absolutize as _absolutize
 
 # whether os_path_to_uri should treat "/" same as "\" in a Windows path
 WINDOWS_SLASH_COMPAT = True
@@ -278,49 +281,10 @@ def matches_uri_syntax(s):
     return URI_PATTERN.match(s) is not None
 
 
-_split_uri_ref_setup_completed = False
-def _init_split_uri_ref_pattern():
-    """
-    Called internally to compile the regular expression used by
-    split_uri_ref() just once, the first time the function is called.
-    """
-    global _split_uri_ref_setup_completed
-    if _split_uri_ref_setup_completed:
-        return
-
-    # Like the others, this regex is also in the public domain.
-    # It is based on this one, from RFC 3986 appendix B
-    # (unchanged from RFC 2396 appendix B):
-    # ^(([^:/?#]+):)?(//([^/?#]*))?([^?#]*)(\?([^#]*))?(#(.*))?
-    regex = r"^(?:(?P<scheme>[^:/?#]+):)?(?://(?P<authority>[^/?#]*))?(?P<path>[^?#]*)(?:\?(?P<query>[^#]*))?(?:#(?P<fragment>.*))?$"
-    global SPLIT_URI_REF_PATTERN
-    SPLIT_URI_REF_PATTERN = re.compile(regex)
-    _split_uri_ref_setup_completed = True
-    return
-
-
-def split_uri_ref(uriref):
-    """
-    Given a valid URI reference as a string, returns a tuple representing the
-    generic URI components, as per RFC 3986 appendix B. The tuple's structure
-    is (scheme, authority, path, query, fragment).
-
-    All values will be strings (possibly empty) or None if undefined.
-
-    Note that per RFC 3986, there is no distinction between a path and
-    an "opaque part", as there was in RFC 2396.
-    """
-    if not _split_uri_ref_setup_completed:
-        _init_split_uri_ref_pattern()
-    # the pattern will match every possible string, so it's safe to
-    # assume there's a groupdict method to call.
-    g = SPLIT_URI_REF_PATTERN.match(uriref).groupdict()
-    scheme      = g['scheme']
-    authority   = g['authority']
-    path        = g['path']
-    query       = g['query']
-    fragment    = g['fragment']
-    return (scheme, authority, path, query, fragment)
+# split_uri_ref() is implemented by the amara.lib._iri extension; it
+# splits a URI reference as the regular expression from RFC 3986
+# appendix B does:
+# ^(([^:/?#]+):)?(//([^/?#]*))?([^?#]*)(\?([^#]*))?(#(.*))?
 
 
 def unsplit_uri_ref(uriRefSeq):
@@ -671,72 +635,18 @@ def absolutize(uriRef, baseUri, limit_schemes=None):
     # - Effective Python 2.4, urllib.basejoin() *is* urlparse.urljoin(),
     #    but urlparse.urljoin() is still based on RFC 1808.
 
-    # This procedure is based on the pseudocode in RFC 3986 sec. 5.2.
-    #
-    # ensure base URI is absolute
-    if is_absolute(uriRef):
-        return uriRef
-    if not baseUri or not is_absolute(baseUri):
+    # This procedure is based on the pseudocode in RFC 3986 sec. 5.2; the
+    # amara.lib._iri extension implements it, and remembers the results
+    # for repeated (reference, base) pairs.
+    result = _absolutize(uriRef, baseUri)
+    if result is None:
         raise IriError(IriError.RELATIVE_BASE_URI,
                            base=baseUri, ref=uriRef)
-    if limit_schemes and get_scheme(baseUri) not in limit_schemes:
+    if limit_schemes and not is_absolute(uriRef):
         scheme = get_scheme(baseUri)
-        raise IriError(IriError.UNSUPPORTED_SCHEME, scheme=scheme)
-    
-    # shortcut for the simplest same-document reference cases
-    if uriRef == '' or uriRef[0] == '#':
-        return baseUri.split('#')[0] + uriRef
-    # ensure a clean slate
-    tScheme = tAuth = tPath = tQuery = None
-    # parse the reference into its components
-    (rScheme, rAuth, rPath, rQuery, rFrag) = split_uri_ref(uriRef)
-    # if the reference is absolute, eliminate '.' and '..' path segments
-    # and skip to the end
-    if rScheme is not None:
-        tScheme = rScheme
-        tAuth = rAuth
-        tPath = remove_dot_segments(rPath)
-        tQuery = rQuery
-    else:
-        # the base URI's scheme, and possibly more, will be inherited
-        (bScheme, bAuth, bPath, bQuery, bFrag) = split_uri_ref(baseUri)
-        # if the reference is a net-path, just eliminate '.' and '..' path
-        # segments; no other changes needed.
-        if rAuth is not None:
-            tAuth = rAuth
-            tPath = remove_dot_segments(rPath)
-            tQuery = rQuery
-        # if it's not a net-path, we need to inherit pieces of the base URI
-        else:
-            # use base URI's path if the reference's path is empty
-            if not rPath:
-                tPath = bPath
-                # use the reference's query, if any, or else the base URI's,
-                tQuery = rQuery is not None and rQuery or bQuery
-            # the reference's path is not empty
-            else:
-                # just use the reference's path if it's absolute
-                if rPath[0] == '/':
-                    tPath = remove_dot_segments(rPath)
-                # merge the reference's relative path with the base URI's path
-                else:
-                    if bAuth is not None and not bPath:
-                        tPath = '/' + rPath
-                    else:
-                        tPath = bPath[:bPath.rfind('/')+1] + rPath
-                    tPath = remove_dot_segments(tPath)
-                # use the reference's query
-                tQuery = rQuery
-            # since the reference isn't a net-path,
-            # use the authority from the base URI
-            tAuth = bAuth
-        # inherit the scheme from the base URI
-        tScheme = bScheme
-    # always use the reference's fragment (but no need to define another var)
-    #tFrag = rFrag
-
-    # now compose the target URI (RFC 3986 sec. 5.3)
-    return unsplit_uri_ref((tScheme, tAuth, tPath, tQuery, rFrag))
+        if scheme not in limit_schemes:
+            raise IriError(IriError.UNSUPPORTED_SCHEME, scheme=scheme)
+    return result
 
 
 def relativize(targetUri, againstUri, subPathOnly=False):
@@ -853,60 +763,7 @@ def relativize(targetUri, againstUri, subPathOnly=False):
     return unsplit_uri_ref([None, None, relativePath] + splitTarget[3:])
 
 
-def remove_dot_segments(path):
-    """
-    Supports absolutize() by implementing the remove_dot_segments function
-    described in RFC 3986 sec. 5.2.  It collapses most of the '.' and '..'
-    segments out of a path without eliminating empty segments. It is intended
-    to be used during the path merging process and may not give expected
-    results when used independently. Use normalize_path_segments() or
-    normalize_path_segments_in_uri() if more general normalization is desired.
-    """
-    # return empty string if entire path is just "." or ".."
-    if path == '.' or path == '..':
-        return path[0:0] # preserves string type
-    # remove all "./" or "../" segments at the beginning
-    while path:
-        if path[:2] == './':
-            path = path[2:]
-        elif path[:3] == '../':
-            path = path[3:]
-        else:
-            break
-    # We need to keep track of whether there was a leading slash,
-    # because we're going to drop it in order to prevent our list of
-    # segments from having an ambiguous empty first item when we call
-    # split().
-    leading_slash = False
-    if path[:1] == '/':
-        path = path[1:]
-        leading_slash = True
-    # replace a trailing "/." with just "/"
-    if path[-2:] == '/.':
-        path = path[:-1]
-    # convert the segments into a list and process each segment in
-    # order from left to right.
-    segments = path.split('/')
-    keepers = []
-    segments.reverse()
-    while segments:
-        seg = segments.pop()
-        # '..' means drop the previous kept segment, if any.
-        # If none, and if the path is relative, then keep the '..'.
-        # If the '..' was the last segment, ensure
-        # that the result ends with '/'.
-        if seg == '..':
-            if keepers:
-                keepers.pop()
-            elif not leading_slash:
-                keepers.append(seg)
-            if not segments:
-                keepers.append('')
-        # ignore '.' segments and keep all others, even empty ones
-        elif seg != '.':
-            keepers.append(seg)
-    # reassemble the kept segments
-    return leading_slash * '/' + '/'.join(keepers)
+# remove_dot_segments() is implemented by the amara.lib._iri extension
 
 
 def normalize_case(uriRef, doHost=False):
@@ -1144,24 +1001,9 @@ def public_id_to_urn(publicid):
 # Miscellaneous public functions
 #
 
-SCHEME_PATTERN = re.compile(r'([a-zA-Z][a-zA-Z0-9+\-.]*):')
-def get_scheme(uriRef):
-    """
-    Obtains, with optimum efficiency, just the scheme from a URI reference.
-    Returns a string, or if no scheme could be found, returns None.
-    """
-    # Using a regex seems to be the best option. Called 50,000 times on
-    # different URIs, on a 1.0-GHz PIII with FreeBSD 4.7 and Python
-    # 2.2.1, this method completed in 0.95s, and 0.05s if there was no
-    # scheme to find. By comparison,
-    #   urllib.splittype()[0] took 1.5s always;
-    #   Ft.Lib.Uri.split_uri_ref()[0] took 2.5s always;
-    #   urlparse.urlparse()[0] took 3.5s always.
-    m = SCHEME_PATTERN.match(uriRef)
-    if m is None:
-        return None
-    else:
-        return m.group(1)
+# get_scheme() and is_absolute() are implemented by the amara.lib._iri
+# extension; the scheme is matched by [a-zA-Z][a-zA-Z0-9+\-.]* followed
+# by ':'.
 
 
 def strip_fragment(uriRef):
@@ -1172,15 +1014,6 @@ def strip_fragment(uriRef):
     return split_fragment(uriRef)[0]
 
 
-def is_absolute(identifier):
-    """
-    Given a string believed to be a URI or URI reference, tests that it is
-    absolute (as per RFC 3986), not relative -- i.e., that it has a scheme.
-    """
-    # We do it this way to avoid compiling another massive regex.
-    return get_scheme(identifier) is not None
-
-
 _ntPathToUriSetupCompleted = False
 def _initNtPathPattern():
     """
@@ -21,6 +21,8 @@ __all__ = [
 'DEFAULT_RESOLVER',
 'scheme_registry_resolver',
 'facade_resolver',
+'resource_cache',
+'cached_resolver',
 'uridict',
 'resolver',
 ]
@@ -222,6 +224,130 @@ class facade_resolver(resolver):
                 return StringIO(str(cachedval))
         return default_resolver.resolve(self, uri, base)
 
+class resource_cache(object):
+    """
+    A size-bounded cache of resource representations (byte strings) keyed
+    by absolute URI.  When either the number of entries or the total number
+    of bytes exceeds its limit, the least recently used entries are
+    discarded.  Keys are normalized as for uridict, so equivalent URIs
+    share an entry.
+
+    Any object with get(uri), put(uri, data) and clear() methods can be
+    used in its place by cached_resolver.
+    """
+    def __init__(self, max_entries=256, max_bytes=16*1024*1024):
+        """
+        max_entries - maximum number of resources held
+        max_bytes - maximum total size of the resources held; a single
+                    resource larger than this is never cached
+        """
+        self.max_entries = max_entries
+        self.max_bytes = max_bytes
+        self._entries = uridict()
+        self._size = 0
+        self._tick = 0
+        return
+
+    def __len__(self):
+        return len(self._entries)
+
+    def __contains__(self, uri):
+        return uri in self._entries
+
+    def get(self, uri):
+        """
+        Return the data cached for the URI, or None if there is none
+        """
+        try:
+            entry = self._entries[uri]
+        except KeyError:
+            return None
+        self._tick += 1
+        entry[0] = self._tick
+        return entry[1]
+
+    def put(self, uri, data):
+        """
+        Cache the data for the URI, evicting older entries as needed
+        """
+        if uri in self._entries:
+            self._size -= len(self._entries[uri][1])
+            del self._entries[uri]
+        if len(data) > self.max_bytes:
+            # Too large to cache, but the older data is still discarded
+            return
+        self._tick += 1
+        self._entries[uri] = [self._tick, data]
+        self._size += len(data)
+        if len(self._entries) > self.max_entries or self._size > self.max_bytes:
+            # Evict in least recently used order.  This is a full sort, but
+            # only happens once the cache has filled.
+            entries = dict.items(self._entries)
+            entries.sort(key=lambda item: item[1][0])
+            for key, (tick, value) in entries:
+                if (len(self._entries) <= self.max_entries and
+                    self._size <= self.max_bytes):
+                    break
+                dict.__delitem__(self._entries, key)
+                self._size -= len(value)
+        return
+
+    def clear(self):
+        self._entries.clear()
+        self._size = 0
+        return
+
+
+class cached_resolver(resolver):
+    """
+    Resolver that keeps the representations it retrieves in a resource
+    cache, so that resources referenced repeatedly (e.g. a shared external
+    entity or XInclude target used by a batch of documents) are fetched
+    only once.  Retrieval itself is delegated to another resolver.
+
+    A single instance can be shared by many input sources and parses:
+
+        r = cached_resolver()
+        for path in paths:
+            doc = amara.parse(inputsource(path, resolver=r))
+
+    You can manipulate the cache directly using the "cache" attribute.
+    """
+    def __init__(self, base=None, cache=None, authorizations=None,
+                 lenient=True):
+        """
+        base - resolver used to retrieve resources not in the cache
+               (defaults to DEFAULT_RESOLVER)
+        cache - object used for storage (defaults to a new resource_cache)
+        """
+        resolver.__init__(self, authorizations, lenient)
+        self.base = base or DEFAULT_RESOLVER
+        if cache is None:
+            cache = resource_cache()
+        self.cache = cache
+        return
+
+    def resolve(self, uriRef, baseUri=None):
+        if isinstance(uriRef, urllib2.Request):
+            # requests may carry headers or data; never cache those
+            return self.base.resolve(uriRef, baseUri)
+        if baseUri is not None:
+            uri = self.absolutize(uriRef, baseUri)
+        else:
+            uri = uriRef
+        if self.authorizations and not self.authorize(uri):
+            raise IriError(IriError.DENIED_BY_RULE, uri=uri)
+        data = self.cache.get(uri)
+        if data is None:
+            stream = self.base.resolve(uri)
+            try:
+                data = stream.read()
+            finally:
+                stream.close()
+            self.cache.put(uri, data)
+        return StringIO(data)
+
+
 #
 class uridict(dict):
     """
@@ -0,0 +1,632 @@
+/***********************************************************************
+ * amara/lib/src/iri.c
+ ***********************************************************************/
+
+static char module_doc[] = "\
+Splitting and resolution of URI references (RFC 3986)\n\
+";
+
+#include "Python.h"
+
+#define MODULE_NAME "amara.lib._iri"
+#define MODULE_INITFUNC init_iri
+
+/* The routines operate on Py_UNICODE characters; byte strings are widened
+ * on the way in and narrowed on the way out, so the results have the same
+ * type as the arguments. */
+typedef struct {
+  PyObject *object;
+  const Py_UNICODE *chars;
+  Py_UNICODE *buffer;           /* widened copy of a byte string */
+  Py_ssize_t size;
+  int is_unicode;
+} Text;
+
+/* A component of a URI reference; `start` is NULL if it is undefined */
+typedef struct {
+  const Py_UNICODE *start;
+  Py_ssize_t size;
+} Span;
+
+enum { SCHEME, AUTHORITY, PATH, QUERY, FRAGMENT, NUM_COMPONENTS };
+
+/* Results of absolutize() by (reference, base) pair.  The same few
+ * references tend to be resolved against the same few base URIs
+ * (xml:base, document(), XInclude).  Equal str and unicode arguments
+ * resolve to results of different types, so there is a dictionary for
+ * each combination of argument types; each is emptied when it fills up. */
+static PyObject *resolved[4];
+#define MAX_RESOLVED 1024
+
+#define IS_ALPHA(c) (((c) >= 'a' && (c) <= 'z') || ((c) >= 'A' && (c) <= 'Z'))
+#define IS_DIGIT(c) ((c) >= '0' && (c) <= '9')
+
+/** Private Routines **************************************************/
+
+/* Sets up `text` for `string`.  If `as_unicode` is true, a byte string is
+ * decoded with the default encoding, as concatenation with a unicode
+ * string would. */
+static int text_init(Text *text, PyObject *string, int as_unicode)
+{
+  Py_ssize_t i;
+
+  text->buffer = NULL;
+  if (PyUnicode_Check(string)) {
+    Py_INCREF(string);
+  } else if (PyString_Check(string)) {
+    if (as_unicode) {
+      string = PyUnicode_FromObject(string);
+      if (string == NULL)
+        return -1;
+    } else {
+      Py_INCREF(string);
+    }
+  } else {
+    PyErr_Format(PyExc_TypeError, "expected string, %.200s found",
+                 string->ob_type->tp_name);
+    return -1;
+  }
+  text->object = string;
+  if (PyUnicode_Check(string)) {
+    text->chars = PyUnicode_AS_UNICODE(string);
+    text->size = PyUnicode_GET_SIZE(string);
+    text->is_unicode = 1;
+  } else {
+    text->size = PyString_GET_SIZE(string);
+    text->buffer = PyMem_New(Py_UNICODE, text->size ? text->size : 1);
+    if (text->buffer == NULL) {
+      Py_DECREF(string);
+      PyErr_NoMemory();
+      return -1;
+    }
+    for (i = 0; i < text->size; i++)
+      text->buffer[i] = (unsigned char) PyString_AS_STRING(string)[i];
+    text->chars = text->buffer;
+    text->is_unicode = 0;
+  }
+  return 0;
+}
+
+static void text_fini(Text *text)
+{
+  if (text->buffer)
+    PyMem_Free(text->buffer);
+  Py_DECREF(text->object);
+}
+
+static PyObject *make_string(const Py_UNICODE *chars, Py_ssize_t size,
+                             int is_unicode)
+{
+  PyObject *result;
+  char *bytes;
+  Py_ssize_t i;
+
+  if (is_unicode)
+    return PyUnicode_FromUnicode(chars, size);
+  result = PyString_FromStringAndSize(NULL, size);
+  if (result) {
+    bytes = PyString_AS_STRING(result);
+    for (i = 0; i < size; i++)
+      bytes[i] = (char) chars[i];
+  }
+  return result;
+}
+
+static PyObject *make_component(Span *span, int is_unicode)
+{
+  if (span->start == NULL) {
+    Py_INCREF(Py_None);
+    return Py_None;
+  }
+  return make_string(span->start, span->size, is_unicode);
+}
+
+#define IS_SCHEME_CHAR(c) \
+  (IS_ALPHA(c) || IS_DIGIT(c) || (c) == '+' || (c) == '-' || (c) == '.')
+
+/* Sets `result` to the length of the scheme matched by
+ * [a-zA-Z][a-zA-Z0-9+\-.]* and followed by ':', or 0 */
+#define SCAN_SCHEME(p, size, result)                                    \
+  do {                                                                  \
+    Py_ssize_t i;                                                       \
+    result = 0;                                                         \
+    if ((size) > 0 && IS_ALPHA((p)[0])) {                               \
+      for (i = 1; i < (size) && IS_SCHEME_CHAR((p)[i]); i++);           \
+      if (i < (size) && (p)[i] == ':')                                  \
+        result = i;                                                     \
+    }                                                                   \
+  } while (0)
+
+/* Returns the scheme length for a str or unicode object, or -1 (with an
+ * exception set) for other objects */
+static Py_ssize_t scheme_length(PyObject *string)
+{
+  Py_ssize_t result;
+
+  if (PyUnicode_Check(string)) {
+    SCAN_SCHEME(PyUnicode_AS_UNICODE(string), PyUnicode_GET_SIZE(string),
+                result);
+  } else if (PyString_Check(string)) {
+    const unsigned char *p = (unsigned char *) PyString_AS_STRING(string);
+    SCAN_SCHEME(p, PyString_GET_SIZE(string), result);
+  } else {
+    PyErr_Format(PyExc_TypeError, "expected string, %.200s found",
+                 string->ob_type->tp_name);
+    return -1;
+  }
+  return result;
+}
+
+/* Splits a URI reference as the regular expression from RFC 3986
+ * appendix B does:
+ *   ^(([^:/?#]+):)?(//([^/?#]*))?([^?#]*)(\?([^#]*))?(#(.*))?
+ * The fragment extends to the end of the string. */
+static void split_components(const Py_UNICODE *p, Py_ssize_t size,
+                             Span components[NUM_COMPONENTS])
+{
+  Py_ssize_t i, j;
+
+  memset(components, 0, sizeof(Span) * NUM_COMPONENTS);
+
+  for (j = 0; j < size; j++) {
+    Py_UNICODE c = p[j];
+    if (c == ':' || c == '/' || c == '?' || c == '#')
+      break;
+  }
+  if (j > 0 && j < size && p[j] == ':') {
+    components[SCHEME].start = p;
+    components[SCHEME].size = j;
+    i = j + 1;
+  } else {
+    i = 0;
+  }
+
+  if (size - i >= 2 && p[i] == '/' && p[i + 1] == '/') {
+    for (j = i + 2; j < size; j++) {
+      Py_UNICODE c = p[j];
+      if (c == '/' || c == '?' || c == '#')
+        break;
+    }
+    components[AUTHORITY].start = p + i + 2;
+    components[AUTHORITY].size = j - (i + 2);
+    i = j;
+  }
+
+  for (j = i; j < size && p[j] != '?' && p[j] != '#'; j++);
+  components[PATH].start = p + i;
+  components[PATH].size = j - i;
+  i = j;
+
+  if (i < size && p[i] == '?') {
+    for (j = i + 1; j < size && p[j] != '#'; j++);
+    components[QUERY].start = p + i + 1;
+    components[QUERY].size = j - (i + 1);
+    i = j;
+  }
+
+  if (i < size) {
+    components[FRAGMENT].start = p + i + 1;
+    components[FRAGMENT].size = size - (i + 1);
+  }
+}
+
+#define IS_DOT(p, n) ((n) == 1 && (p)[0] == '.')
+#define IS_DOT_DOT(p, n) ((n) == 2 && (p)[0] == '.' && (p)[1] == '.')
+
+/* Writes `path` with its '.' and '..' segments removed to `out`, which
+ * must have room for `size` + 1 characters.  Returns the number of
+ * characters written, or -1 on error. */
+static Py_ssize_t dot_segments_removed(const Py_UNICODE *path, Py_ssize_t size,
+                                       Py_UNICODE *out)
+{
+  const Py_UNICODE *p = path, *end = path + size, *segment;
+  Span *keepers;
+  Py_ssize_t nkeepers = 0, i, length;
+  int leading_slash;
+
+  /* an empty string if the entire path is just "." or ".." */
+  if (IS_DOT(p, size) || IS_DOT_DOT(p, size))
+    return 0;
+  /* remove all "./" or "../" segments at the beginning */
+  while (p < end) {
+    if (end - p >= 2 && p[0] == '.' && p[1] == '/')
+      p += 2;
+    else if (end - p >= 3 && p[0] == '.' && p[1] == '.' && p[2] == '/')
+      p += 3;
+    else
+      break;
+  }
+  leading_slash = (p < end && *p == '/');
+  if (leading_slash)
+    p++;
+  /* a trailing "/." becomes just "/" */
+  if (end - p >= 2 && end[-2] == '/' && end[-1] == '.')
+    end--;
+
+  /* at most one more kept segment than there are characters */
+  keepers = PyMem_New(Span, (end - p) + 2);
+  if (keepers == NULL) {
+    PyErr_NoMemory();
+    return -1;
+  }
+  for (segment = p; ; segment = p + 1) {
+    for (p = segment; p < end && *p != '/'; p++);
+    length = p - segment;
+    if (IS_DOT_DOT(segment, length)) {
+      /* drop the previous kept segment, or keep the '..' if there is
+       * none and the path is relative; if it was the last segment, the
+       * result ends with '/' */
+      if (nkeepers)
+        nkeepers--;
+      else if (!leading_slash) {
+        keepers[nkeepers].start = segment;
+        keepers[nkeepers++].size = length;
+      }
+      if (p == end) {
+        keepers[nkeepers].start = p;
+        keepers[nkeepers++].size = 0;
+      }
+    } else if (!IS_DOT(segment, length)) {
+      /* keep all others, even empty ones */
+      keepers[nkeepers].start = segment;
+      keepers[nkeepers++].size = length;
+    }
+    if (p == end)
+      break;
+  }
+
+  length = 0;
+  if (leading_slash)
+    out[length++] = '/';
+  for (i = 0; i < nkeepers; i++) {
+    if (i)
+      out[length++] = '/';
+    Py_UNICODE_COPY(out + length, keepers[i].start, keepers[i].size);
+    length += keepers[i].size;
+  }
+  PyMem_Free(keepers);
+  return length;
+}
+
+static Py_UNICODE *append(Py_UNICODE *out, const char *prefix, Span *span)
+{
+  if (span->start != NULL) {
+    while (*prefix)
+      *out++ = (Py_UNICODE) *prefix++;
+    Py_UNICODE_COPY(out, span->start, span->size);
+    out += span->size;
+  }
+  return out;
+}
+
+/* RFC 3986 section 5.2.2; `ref` has no scheme and `base` has one */
+static PyObject *resolve(Text *ref, Text *base)
+{
+  Span r[NUM_COMPONENTS], b[NUM_COMPONENTS], t[NUM_COMPONENTS];
+  Py_UNICODE *merged = NULL, *path = NULL, *buffer, *out;
+  Py_ssize_t size;
+  PyObject *result = NULL;
+  int is_unicode = ref->is_unicode;
+
+  /* shortcut for the simplest same-document reference cases */
+  if (ref->size == 0 || ref->chars[0] == '#') {
+    for (size = 0; size < base->size && base->chars[size] != '#'; size++);
+    buffer = PyMem_New(Py_UNICODE, size + ref->size + 1);
+    if (buffer == NULL)
+      return PyErr_NoMemory();
+    Py_UNICODE_COPY(buffer, base->chars, size);
+    Py_UNICODE_COPY(buffer + size, ref->chars, ref->size);
+    result = make_string(buffer, size + ref->size, is_unicode);
+    PyMem_Free(buffer);
+    return result;
+  }
+
+  split_components(ref->chars, ref->size, r);
+  /* room for the merged path and its dot segments removed */
+  path = PyMem_New(Py_UNICODE, ref->size + base->size + 3);
+  if (path == NULL)
+    return PyErr_NoMemory();
+  memset(t, 0, sizeof(t));
+  t[FRAGMENT] = r[FRAGMENT];
+
+  if (r[SCHEME].start != NULL) {
+    t[SCHEME] = r[SCHEME];
+    t[AUTHORITY] = r[AUTHORITY];
+    t[PATH].start = path;
+    t[PATH].size = dot_segments_removed(r[PATH].start, r[PATH].size, path);
+    t[QUERY] = r[QUERY];
+  } else {
+    /* the base URI's scheme, and possibly more, will be inherited */
+    split_components(base->chars, base->size, b);
+    if (r[AUTHORITY].start != NULL) {
+      t[AUTHORITY] = r[AUTHORITY];
+      t[PATH].start = path;
+      t[PATH].size = dot_segments_removed(r[PATH].start, r[PATH].size, path);
+      t[QUERY] = r[QUERY];
+    } else {
+      if (r[PATH].size == 0) {
+        t[PATH] = b[PATH];
+        t[QUERY] = r[QUERY].start != NULL && r[QUERY].size ? r[QUERY]
+                                                           : b[QUERY];
+      } else {
+        if (r[PATH].start[0] == '/') {
+          t[PATH].start = path;
+          t[PATH].size = dot_segments_removed(r[PATH].start, r[PATH].size,
+                                              path);
+        } else {
+          /* merge the reference's path with the base URI's path */
+          merged = PyMem_New(Py_UNICODE, ref->size + base->size + 1);
+          if (merged == NULL) {
+            PyMem_Free(path);
+            return PyErr_NoMemory();
+          }
+          if (b[AUTHORITY].start != NULL && b[PATH].size == 0) {
+            merged[0] = '/';
+            size = 1;
+          } else {
+            for (size = b[PATH].size; size > 0; size--) {
+              if (b[PATH].start[size - 1] == '/')
+                break;
+            }
+            Py_UNICODE_COPY(merged, b[PATH].start, size);
+          }
+          Py_UNICODE_COPY(merged + size, r[PATH].start, r[PATH].size);
+          size += r[PATH].size;
+          t[PATH].start = path;
+          t[PATH].size = dot_segments_removed(merged, size, path);
+          PyMem_Free(merged);
+        }
+        t[QUERY] = r[QUERY];
+      }
+      t[AUTHORITY] = b[AUTHORITY];
+    }
+    t[SCHEME] = b[SCHEME];
+  }
+  if (t[PATH].size < 0) {
+    PyMem_Free(path);
+    return NULL;
+  }
+
+  /* now compose the target URI (RFC 3986 section 5.3) */
+  buffer = PyMem_New(Py_UNICODE, ref->size + base->size + t[PATH].size + 8);
+  if (buffer == NULL) {
+    PyMem_Free(path);
+    return PyErr_NoMemory();
+  }
+  out = buffer;
+  if (t[SCHEME].start != NULL) {
+    Py_UNICODE_COPY(out, t[SCHEME].start, t[SCHEME].size);
+    out += t[SCHEME].size;
+    *out++ = ':';
+  }
+  out = append(out, "//", &t[AUTHORITY]);
+  if (t[PATH].start != NULL) {
+    Py_UNICODE_COPY(out, t[PATH].start, t[PATH].size);
+    out += t[PATH].size;
+  }
+  out = append(out, "?", &t[QUERY]);
+  out = append(out, "#", &t[FRAGMENT]);
+  result = make_string(buffer, out - buffer, is_unicode);
+  PyMem_Free(buffer);
+  PyMem_Free(path);
+  return result;
+}
+
+/* absolutize() without the memo */
+static PyObject *absolutize_uncached(PyObject *uriref, PyObject *base)
+{
+  PyObject *result;
+  Text ref_text, base_text;
+  Span components[NUM_COMPONENTS];
+  Py_ssize_t size;
+  int as_unicode;
+
+  size = scheme_length(uriref);
+  if (size < 0)
+    return NULL;
+  if (size) {
+    Py_INCREF(uriref);
+    return uriref;
+  }
+  switch (PyObject_IsTrue(base)) {
+  case -1:
+    return NULL;
+  case 0:
+    Py_RETURN_NONE;
+  }
+  size = scheme_length(base);
+  if (size < 0)
+    return NULL;
+  if (size == 0)
+    Py_RETURN_NONE;
+
+  /* The result is unicode if either argument is, unless every component
+   * comes from the reference: a scheme that is not a valid one (e.g.,
+   * "1a:b") is still split off as one. */
+  if (text_init(&ref_text, uriref, 0) < 0)
+    return NULL;
+  split_components(ref_text.chars, ref_text.size, components);
+  if (components[SCHEME].start != NULL) {
+    as_unicode = 0;
+  } else {
+    as_unicode = ref_text.is_unicode || PyUnicode_Check(base);
+    if (as_unicode && !ref_text.is_unicode) {
+      text_fini(&ref_text);
+      if (text_init(&ref_text, uriref, 1) < 0)
+        return NULL;
+    }
+  }
+  if (text_init(&base_text, base, as_unicode) < 0) {
+    text_fini(&ref_text);
+    return NULL;
+  }
+  result = resolve(&ref_text, &base_text);
+  text_fini(&ref_text);
+  text_fini(&base_text);
+  return result;
+}
+
+/** Public Methods ****************************************************/
+
+static char split_uri_ref_doc[] =
+"split_uri_ref(uriref) -> tuple\n\
+\n\
+Given a valid URI reference as a string, returns a tuple representing the\n\
+generic URI components, as per RFC 3986 appendix B. The tuple's structure\n\
+is (scheme, authority, path, query, fragment).\n\
+\n\
+All values will be strings (possibly empty) or None if undefined.\n\
+\n\
+Note that per RFC 3986, there is no distinction between a path and\n\
+an \"opaque part\", as there was in RFC 2396.";
+
+static PyObject *split_uri_ref(PyObject *self, PyObject *uriref)
+{
+  Span components[NUM_COMPONENTS];
+  PyObject *result, *item;
+  Text text;
+  int i;
+
+  if (text_init(&text, uriref, 0) < 0)
+    return NULL;
+  split_components(text.chars, text.size, components);
+  result = PyTuple_New(NUM_COMPONENTS);
+  for (i = 0; result && i < NUM_COMPONENTS; i++) {
+    item = make_component(&components[i], text.is_unicode);
+    if (item == NULL)
+      Py_CLEAR(result);
+    else
+      PyTuple_SET_ITEM(result, i, item);
+  }
+  text_fini(&text);
+  return result;
+}
+
+static char remove_dot_segments_doc[] =
+"remove_dot_segments(path) -> string\n\
+\n\
+Supports absolutize() by implementing the remove_dot_segments function\n\
+described in RFC 3986 sec. 5.2.  It collapses most of the '.' and '..'\n\
+segments out of a path without eliminating empty segments. It is intended\n\
+to be used during the path merging process and may not give expected\n\
+results when used independently. Use normalize_path_segments() or\n\
+normalize_path_segments_in_uri() if more general normalization is desired.";
+
+static PyObject *remove_dot_segments(PyObject *self, PyObject *path)
+{
+  PyObject *result = NULL;
+  Py_UNICODE *out;
+  Py_ssize_t size;
+  Text text;
+
+  if (text_init(&text, path, 0) < 0)
+    return NULL;
+  out = PyMem_New(Py_UNICODE, text.size + 1);
+  if (out == NULL) {
+    PyErr_NoMemory();
+  } else {
+    size = dot_segments_removed(text.chars, text.size, out);
+    if (size >= 0)
+      result = make_string(out, size, text.is_unicode);
+    PyMem_Free(out);
+  }
+  text_fini(&text);
+  return result;
+}
+
+static char get_scheme_doc[] =
+"get_scheme(uriRef) -> string or None\n\
+\n\
+Obtains, with optimum efficiency, just the scheme from a URI reference.\n\
+Returns a string, or if no scheme could be found, returns None.";
+
+static PyObject *get_scheme(PyObject *self, PyObject *uriref)
+{
+  Py_ssize_t size = scheme_length(uriref);
+
+  if (size < 0)
+    return NULL;
+  if (size == 0)
+    Py_RETURN_NONE;
+  return PySequence_GetSlice(uriref, 0, size);
+}
+
+static char is_absolute_doc[] =
+"is_absolute(identifier) -> bool\n\
+\n\
+Given a string believed to be a URI or URI reference, tests that it is\n\
+absolute (as per RFC 3986), not relative -- i.e., that it has a scheme.";
+
+static PyObject *is_absolute(PyObject *self, PyObject *identifier)
+{
+  Py_ssize_t size = scheme_length(identifier);
+
+  if (size < 0)
+    return NULL;
+  return PyBool_FromLong(size);
+}
+
+static char absolutize_doc[] =
+"absolutize(uriRef, baseUri) -> string or None\n\
+\n\
+Resolves `uriRef` against `baseUri` as described in RFC 3986 section 5.\n\
+Returns `uriRef` itself if it is absolute, or None if it is relative and\n\
+`baseUri` is empty or not absolute.  The result is a unicode string if\n\
+either argument is one.  The results for repeated (uriRef, baseUri) pairs\n\
+are remembered.";
+
+static PyObject *absolutize(PyObject *self, PyObject *args)
+{
+  PyObject *uriref, *base, *result, *cache, *key;
+
+  if (!PyArg_ParseTuple(args, "OO:absolutize", &uriref, &base))
+    return NULL;
+
+  if ((PyString_CheckExact(uriref) || PyUnicode_CheckExact(uriref)) &&
+      (PyString_CheckExact(base) || PyUnicode_CheckExact(base))) {
+    cache = resolved[PyUnicode_CheckExact(uriref) * 2 +
+                     PyUnicode_CheckExact(base)];
+    key = PyTuple_Pack(2, uriref, base);
+    if (key == NULL)
+      return NULL;
+    result = PyDict_GetItem(cache, key);
+    if (result) {
+      Py_DECREF(key);
+      Py_INCREF(result);
+      return result;
+    }
+    result = absolutize_uncached(uriref, base);
+    if (result != NULL && result != Py_None) {
+      if (PyDict_Size(cache) >= MAX_RESOLVED)
+        PyDict_Clear(cache);
+      if (PyDict_SetItem(cache, key, result) < 0)
+        Py_CLEAR(result);
+    }
+    Py_DECREF(key);
+    return result;
+  }
+  return absolutize_uncached(uriref, base);
+}
+
+static PyMethodDef module_methods[] = {
+  { "split_uri_ref", split_uri_ref, METH_O, split_uri_ref_doc },
+  { "remove_dot_segments", remove_dot_segments, METH_O,
+    remove_dot_segments_doc },
+  { "get_scheme", get_scheme, METH_O, get_scheme_doc },
+  { "is_absolute", is_absolute, METH_O, is_absolute_doc },
+  { "absolutize", absolutize, METH_VARARGS, absolutize_doc },
+  { NULL }
+};
+
+PyMODINIT_FUNC MODULE_INITFUNC(void)
+{
+  int i;
+
+  if (Py_InitModule3(MODULE_NAME, module_methods, module_doc) == NULL)
+    return;
+  for (i = 0; i < 4; i++) {
+    resolved[i] = PyDict_New();
+    if (resolved[i] == NULL)
+      return;
+  }
+}
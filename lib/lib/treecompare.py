@@ -40,6 +40,9 @@ _starttag_find = re.compile("<[^!?]").search
 _html_find = re.compile("(<!DOCTYPE html)|(<html)", re.IGNORECASE).search
 
 
+_CHUNK_SIZE = 65536
+
+
 def check_xml(result, expected):
     '''
     A useful XML comparison routine for test cases, error reports, etc.
@@ -58,7 +61,8 @@ def document_compare(expected, compared, whitespace=True):
 
 def document_diff(expected, compared, whitespace=True):
     # See if we need to use XML or HTML
-    if not _xmldecl_match(expected) and _html_find(expected):
+    head, expected = _peek(expected)
+    if not _xmldecl_match(head) and _html_find(head):
         diff = html_diff
     else:
         diff = xml_diff
@@ -79,15 +83,15 @@ def html_compare(expected, compared, whitespace=True):
 
 def html_diff(expected, compared, whitespace=True):
     """
-    Compare two HTML strings; generate the delta as a unified diff.
+    Compare two HTML strings; generate the delta as a unified diff
+    located at their first difference.
 
     `ignorews` controls whether whitespace differences in text
     events are ignored.
     """
     expected = _html_sequence(expected, whitespace)
     compared = _html_sequence(compared, whitespace)
-    return difflib.unified_diff(expected, compared, 'expected', 'compared',
-                                n=2, lineterm='')
+    return _event_diff(expected, compared)
 
 
 def xml_compare(expected, compared, whitespace=True, lexical=True):
@@ -107,45 +111,166 @@ def xml_diff(expected, compared, whitespace=True):
     # DOCTYPE declaration.
     # See XML 1.0 2nd, 4.3.2, Well-Formed Parsed Entities
     sequencer = _xml_sequence
-    if _textdecl_match(expected):
+    head, expected = _peek(expected)
+    if _textdecl_match(head):
         # Limit the search for DOCTYPE to the content before the first element.
         # If no elements exist, it *MUST* be a parsed entity.
-        match = _starttag_find(expected)
-        if not match or not _doctype_find(expected, 0, match.start()):
+        match = _starttag_find(head)
+        if not match or not _doctype_find(head, 0, match.start()):
             sequencer = _entity_sequence
     expected = sequencer(expected, whitespace)
     compared = sequencer(compared, whitespace)
-    return difflib.unified_diff(expected, compared, 'expected', 'compared',
-                                n=2, lineterm='')
+    return _event_diff(expected, compared)
 
 
 def entity_compare(expected, compared, ignorews=False):
     return
 
 
+def _chunks(data):
+    """
+    Generates the document `data` a piece at a time. `data` can be a string,
+    a file-like object or an iterable of strings.
+    """
+    if isinstance(data, basestring):
+        for start in xrange(0, len(data), _CHUNK_SIZE):
+            yield data[start:start+_CHUNK_SIZE]
+    elif hasattr(data, 'read'):
+        chunk = data.read(_CHUNK_SIZE)
+        while chunk:
+            yield chunk
+            chunk = data.read(_CHUNK_SIZE)
+    else:
+        for chunk in data:
+            yield chunk
+
+
+def _peek(data):
+    """
+    Returns the first chunk of the document `data` (used to sniff its type)
+    along with the chunks of the complete document.
+    """
+    chunks = _chunks(data)
+    for head in chunks:
+        return head, itertools.chain((head,), chunks)
+    return '', ()
+
+
+def _location(sequence, index):
+    if index < len(sequence):
+        return 'line %d' % sequence.lines[index]
+    return 'end of document'
+
+
+def _event_diff(expected, compared, context=2, window=8):
+    """
+    Parses the documents of the sequences `expected` and `compared` in
+    lockstep and generates a unified diff of the events around their first
+    difference, if any.  Neither document is parsed much further than that.
+    """
+    try:
+        history = []
+        offset = 0
+        while True:
+            # Discard the events both sides have in common so far
+            size = min(len(expected), len(compared))
+            if expected[:size] != compared[:size]:
+                break
+            history = (history + expected[max(size - context, 0):size])[-context:]
+            offset += size
+            del expected[:size], expected.lines[:size]
+            del compared[:size], compared.lines[:size]
+            if not expected and expected.advance():
+                continue
+            if not compared and compared.advance():
+                continue
+            if not expected and not compared:
+                # both documents are exhausted
+                return
+            if not expected or not compared:
+                break
+
+        size = min(len(expected), len(compared))
+        for index in xrange(size):
+            if expected[index] != compared[index]:
+                break
+        else:
+            index = size
+        yield '--- expected'
+        yield '+++ compared'
+        yield '@@ event %d: expected %s, compared %s @@' % (
+            offset + index + 1, _location(expected, index),
+            _location(compared, index))
+        for event in (history + expected[:index])[-context:]:
+            yield ' ' + event
+        for sequence in (expected, compared):
+            while len(sequence) < index + window and sequence.advance():
+                pass
+        x = expected[index:index+window]
+        y = compared[index:index+window]
+        matcher = difflib.SequenceMatcher(None, x, y)
+        for tag, i1, i2, j1, j2 in matcher.get_opcodes():
+            if tag == 'equal':
+                for event in x[i1:i2]:
+                    yield ' ' + event
+            else:
+                for event in x[i1:i2]:
+                    yield '-' + event
+                for event in y[j1:j2]:
+                    yield '+' + event
+    finally:
+        expected.release()
+        compared.release()
+    return
+
+
 class _markup_sequence(list):
-    __slots__ = ('_data', '_nsdecls')
+    """
+    The normalized events of a document, along with the line on which each
+    occurs in `lines`.  The document is parsed a chunk at a time by
+    `advance()`, so the list holds only those events not yet discarded by
+    the caller.
+    """
+    __slots__ = ('lines', '_chunks', '_whitespace', '_data', '_data_line',
+                 '_nsdecls')
     def __init__(self, data, whitespace=True):
         list.__init__(self)
-        if not whitespace:
-            self._flush = self._flush_whitespace
+        self._whitespace = whitespace
+        self.lines = []
+        self._chunks = _chunks(data)
         self._data = u''
+        self._data_line = None
         self._nsdecls = []
-        self.feed(data)
+
+    def advance(self):
+        """
+        Parses the next chunk of the document.  Returns `False` if the
+        document was already exhausted.
+        """
+        chunks = self._chunks
+        if chunks is None:
+            return False
+        for chunk in chunks:
+            self.feed(chunk)
+            return True
         self.close()
         self._flush()
+        self.release()
+        return True
 
-    def _flush(self):
-        data = self._data
-        if data:
-            self.append('#text: ' + repr(data))
-            self._data = u''
+    def release(self):
+        self._chunks = None
 
-    def _flush_whitespace(self):
+    def _event(self, event):
+        self.append(event)
+        self.lines.append(self._line())
+
+    def _flush(self):
         data = self._data
         if data:
-            if not isspace(data):
+            if self._whitespace or not isspace(data):
                 self.append('#text: ' + repr(data))
+                self.lines.append(self._data_line)
             self._data = u''
 
     def namespace_decl(self, prefix, uri):
@@ -155,52 +280,54 @@ class _markup_sequence(list):
 
     def start_element(self, name, attrs):
         if self._data: self._flush()
-        self.append('start-tag: ' + name)
+        self._event('start-tag: ' + name)
         if self._nsdecls:
             nsdecls = sorted(self._nsdecls)
             nsdecls = [ '%s=%r' % pair for pair in nsdecls ]
-            self.append('  namespaces: ' + ', '.join(nsdecls))
+            self._event('  namespaces: ' + ', '.join(nsdecls))
             del self._nsdecls[:]
         if attrs:
             attrs = self._prepare_attrs(attrs)
             attrs = [ '%s=%r' % pair for pair in attrs ]
-            self.append('  attributes: ' + ', '.join(attrs))
+            self._event('  attributes: ' + ', '.join(attrs))
         return
 
     def end_element(self, name):
         if self._data: self._flush()
-        self.append('end-tag: ' + name)
+        self._event('end-tag: ' + name)
 
     def characters(self, data):
         if data:
+            if not self._data:
+                self._data_line = self._line()
             self._data += data
 
     def processing_instruction(self, target, data):
         if self._data: self._flush()
         event = 'processing-instruction: target=%s, data=%r' % (target, data)
-        self.append(event)
+        self._event(event)
 
     def entity_ref(self, name):
         if self._data: self._flush()
-        self.append('entity-ref: name=' + name)
+        self._event('entity-ref: name=' + name)
 
     def comment(self, data):
         if self._data: self._flush()
-        self.append('#comment: ' + repr(data))
+        self._event('#comment: ' + repr(data))
 
     def start_cdata(self):
         if self._data: self._flush()
-        self.append('start-cdata')
+        self._event('start-cdata')
 
     def end_cdata(self):
         if self._data: self._flush()
-        self.append('end-cdata')
+        self._event('end-cdata')
 
     def doctype_decl(self, name, sysid, pubid, has_internal_subset):
         if self._data: self._flush()
         event = 'doctype-decl: name=%s, sysid=%r, pubid=%r, subset=%s' % (
             name, sysid, pubid, ('yes' if has_internal_subset else 'no'))
-        self.append(event)
+        self._event(event)
 
 
 class _xml_sequence(_markup_sequence):
@@ -229,13 +356,19 @@ class _xml_sequence(_markup_sequence):
         it = iter(attrs)
         return sorted(itertools.izip(it, it))
 
+    def _line(self):
+        return self._parser.CurrentLineNumber
+
     def feed(self, data):
         self._parser.Parse(data, 0)
 
     def close(self):
         self._parser.Parse('', 1)
+
+    def release(self):
         # break cycle created by expat handlers pointing to our methods
         self._parser = None
+        _markup_sequence.release(self)
 
 
 class _entity_sequence(_xml_sequence):
@@ -258,6 +391,9 @@ class _html_sequence(HTMLParser.HTMLParser, _markup_sequence):
             self.handle_comment = self.comment
         _markup_sequence.__init__(self, data, whitespace)
 
+    def _line(self):
+        return self.getpos()[0]
+
     handle_starttag = _markup_sequence.start_element
     handle_endtag = _markup_sequence.end_element
     handle_charref = _markup_sequence.entity_ref
@@ -281,16 +281,30 @@ from amara.lib.util import readbysep
 import cStringIO
 f = cStringIO.StringIO('<a/>\f<b/>\f<c/>')
 [ parse(x).xml_select(u'name(*)') for x in readbysep(f, '\f') ]
+
+#To parse XML records, amara.tree.parse_records is much faster
     '''
-    leftover = ''
+    #Pieces of the current record, so long records are only joined once
+    pieces = []
+    keep = len(sep) - 1
     while 1:
         next = f.read(buffersize)
         if not next: #empty string at EOF
-            yield leftover
+            yield ''.join(pieces)
             break
-        chunks = (leftover + next).split(sep)
-        leftover = chunks[-1]
-        for chunk in chunks[:-1]: yield chunk
+        if keep and pieces:
+            #A separator might straddle the buffer boundary
+            last = pieces.pop()
+            next = last[-keep:] + next
+            if len(last) > keep:
+                pieces.append(last[:-keep])
+        chunks = next.split(sep)
+        if len(chunks) > 1:
+            pieces.append(chunks[0])
+            yield ''.join(pieces)
+            for chunk in chunks[1:-1]: yield chunk
+            pieces = []
+        pieces.append(chunks[-1])
     return
 
 
@@ -1,5 +1,7 @@
 import itertools
+import operator
 
+from amara.xpath import datatypes
 from amara.xpath import parser as xpath_parser
 from amara.xpath import locationpaths
 from amara.xpath.locationpaths import axisspecifiers
@@ -11,10 +13,23 @@ from amara.xpath.expressions import basics
 
 counter = itertools.count(1)
 
+# Predicates are evaluated when the element starts, so they can only
+# look at the element's attributes and its position among its siblings.
+
+_comparisons = {u'=': operator.eq, u'!=': operator.ne,
+                u'<': operator.lt, u'<=': operator.le,
+                u'>': operator.gt, u'>=': operator.ge}
+# The same comparison with the operands swapped ("4=@x" -> "@x=4")
+_swapped = {u'=': u'=', u'!=': u'!=', u'<': u'>', u'<=': u'>=',
+            u'>': u'<', u'>=': u'<='}
+
 # [@x]
 class AttributeExistsPred(object):
     def __init__(self, name):
         self.name = name
+        self.key = ('@', name)
+    def matches(self, attrs):
+        return self.name in attrs
 
 # [@x="a"]
 class AttributeBinOpPred(object):
@@ -22,6 +37,26 @@ class AttributeBinOpPred(object):
         self.name = name
         self.op = op
         self.value = value
+        self.key = ('@', name, op, value)
+        self._compare = _comparisons[op]
+    def matches(self, attrs):
+        value = attrs.get(self.name)
+        if value is None:
+            # comparisons with an empty node-set are always false
+            return False
+        if isinstance(self.value, float):
+            value = datatypes.number(value)
+        return self._compare(value, self.value)
+
+# [2], [position()=2], [position()<3]
+class PositionPred(object):
+    def __init__(self, op, value):
+        self.op = op
+        self.value = value
+        self.key = ('position', op, value)
+        self._compare = _comparisons[op]
+    def matches(self, position):
+        return self._compare(position, self.value)
 
 class AttributeFunctionCallPred(object):
     def __init__(self, func):
@@ -46,10 +81,45 @@ class NodeTest(BaseNodeTest):
         # (ns, name)
         self.name = name
         self.predicates = predicates
+        # Tests with the same key always agree on a given element
+        self.key = (name, predicates and tuple(p.key for p in predicates))
+        if predicates:
+            self.function = _predicate_function(name, predicates)
+        else:
+            self.function = None
 
     def __str__(self):
         return "Node ns=%r localname=%r predicates=%r" % (self.name[0], self.name[1],
-                                                          self.predicates)
+                                                          self.key[1])
+
+def _predicate_function(name, predicates):
+    # Returns test(attrs, counters, positions) for use in the element
+    # decision tree.  `counters` holds, for the parent element, the number
+    # of children seen so far for each position key, and `positions` caches
+    # the current element's position for each key so that several tests
+    # with the same key only count it once.
+    steps = []
+    for i, pred in enumerate(predicates):
+        if isinstance(pred, PositionPred):
+            # positions count the siblings which passed the preceding
+            # predicates of the step
+            steps.append((pred, (name, tuple(p.key for p in predicates[:i]))))
+        else:
+            steps.append((pred, None))
+    def test(attrs, counters, positions):
+        for pred, key in steps:
+            if key is None:
+                if not pred.matches(attrs):
+                    return False
+            else:
+                position = positions.get(key)
+                if position is None:
+                    position = positions[key] = counters[key] = \
+                        counters.get(key, 0) + 1
+                if not pred.matches(position):
+                    return False
+        return True
+    return test
 
 # predicates make no sense here because we only support downward axes
 # and these have no downward axes. (XXX I think.)
@@ -207,29 +277,36 @@ def to_nfa(expr, namespaces):
             klass = AttributeTest
         else:
             klass = NodeTest
+        predicates = to_predicates(expr.predicates, namespaces)
+        if (axis_name == "descendant" and predicates and
+            [ p for p in predicates if isinstance(p, PositionPred) ]):
+            # positions would be relative to all the descendants
+            raise NotImplementedError(
+                "pushtree does not support positional predicates on the "
+                "descendant axis: %s" % expr)
 
         nfa = NFA()
         node_test = expr.node_test
         if node_test.__class__ is nodetests.local_name_test:
             # Something without a namespace, like "a"
             node_id = nfa.new_node(None,
-                                   klass(node_test.name_key, expr.predicates))
+                                   klass(node_test.name_key, predicates))
         elif node_test.__class__ is nodetests.namespace_test:
             # Namespace but no name, like "a:*"
             namespace = namespaces[node_test._prefix]
             node_id = nfa.new_node(None,
-                                   klass((namespace, None), expr.predicates))
+                                   klass((namespace, None), predicates))
         elif node_test.__class__ is nodetests.qualified_name_test:
             prefix, localname = node_test.name_key
             namespace = namespaces[prefix]
             node_id = nfa.new_node(None,
-                                   klass((namespace, localname), expr.predicates))
+                                   klass((namespace, localname), predicates))
         elif node_test.__class__ is nodetests.processing_instruction_test:
             node_id = nfa.new_node(None,
                                    ProcessingInstructionTest(node_test._target))
         elif node_test.__class__ is locationpaths.nodetests.principal_type_test:
             node_id = nfa.new_node(None,
-                                   klass((None, None), None))
+                                   klass((None, None), predicates))
         else:
             die(node_test)
 
@@ -251,12 +328,78 @@ def to_nfa(expr, namespaces):
 
     die(expr)
 
+def _attribute_name(expr, namespaces):
+    # The (namespace, localname) of "@x" or "@p:x", otherwise None
+    if expr.__class__ is not locationpaths.relative_location_path:
+        return None
+    if len(expr._steps) != 1:
+        return None
+    step = expr._steps[0]
+    if step.axis.name != "attribute" or step.predicates:
+        return None
+    node_test = step.node_test
+    if node_test.__class__ is nodetests.local_name_test:
+        return node_test.name_key
+    if node_test.__class__ is nodetests.qualified_name_test:
+        prefix, localname = node_test.name_key
+        return (namespaces[prefix], localname)
+    return None
+
+def to_predicates(predicates, namespaces):
+    if not predicates:
+        return None
+    result = []
+    for pred in predicates:
+        expr = pred._expr
+        name = _attribute_name(expr, namespaces)
+        if name is not None:
+            # [@x]
+            result.append(AttributeExistsPred(name))
+            continue
+        if isinstance(expr, basics.number_literal):
+            # [2]
+            result.append(PositionPred(u'=', float(expr._literal)))
+            continue
+        if isinstance(expr, (booleans.equality_expr, booleans.relational_expr)):
+            op, left, right = expr._op, expr._left, expr._right
+            if isinstance(left, basics.literal):
+                op, left, right = _swapped[op], right, left
+            if isinstance(right, basics.literal):
+                if isinstance(left, nodesets.position_function):
+                    # [position()=2]
+                    result.append(PositionPred(op, float(right._literal)))
+                    continue
+                name = _attribute_name(left, namespaces)
+                if name is not None:
+                    # [@x="a"], [@x>2]; strings compare as numbers unless
+                    # the comparison is for (in)equality with a string
+                    if (isinstance(right, basics.number_literal) or
+                        isinstance(expr, booleans.relational_expr)):
+                        value = float(datatypes.number(right._literal))
+                    else:
+                        value = unicode(right._literal)
+                    result.append(AttributeBinOpPred(name, op, value))
+                    continue
+        raise NotImplementedError(
+            "pushtree does not support the predicate %s" % pred)
+    return tuple(result)
+
+def _name_covers(general, specific):
+    # Every name matching `specific` also matches `general`
+    # (None is a wildcard)
+    return ((general[0] is None or general[0] == specific[0]) and
+            (general[1] is None or general[1] == specific[1]))
+
+def _names_disjoint(name1, name2):
+    return ((name1[0] is not None and name2[0] is not None and
+             name1[0] != name2[0]) or
+            (name1[1] is not None and name2[1] is not None and
+             name1[1] != name2[1]))
+
 def node_intersect(parent_test, child_test):
     if parent_test is not None:
         assert isinstance(parent_test, BaseNodeTest), parent_test
-        assert getattr(parent_test, "predicates", None) is None
     assert isinstance(child_test, BaseNodeTest), child_test
-    assert getattr(child_test, "predicates", None) is None
 
     if parent_test is None:
         if isinstance(child_test, AnyNodeTest):
@@ -275,10 +418,23 @@ def node_intersect(parent_test, child_test):
         if isinstance(child_test, NodeTest):
             # XXX This is wrong. Resolved namespaces can be the same even
             # if the namespace fields are different.
-            # XXX check for predicates!
-            if parent_test.name == child_test.name:
+            if child_test.key == parent_test.key:
                 return True, False
-            return False, child_test
+            # When the parent test passed...
+            if _names_disjoint(parent_test.name, child_test.name):
+                if_true = False
+            elif (not child_test.predicates and
+                  _name_covers(child_test.name, parent_test.name)):
+                if_true = True
+            else:
+                if_true = child_test
+            # ...and when it failed
+            if (not parent_test.predicates and
+                _name_covers(parent_test.name, child_test.name)):
+                if_false = False
+            else:
+                if_false = child_test
+            return if_true, if_false
 
 def attr_intersect(parent_test, child_test):
     if parent_test is not None:
@@ -535,7 +691,8 @@ def build_states(nfa, dfa, numbering):
             if not tree:
                 node_ops = []  # ... because there are no states
             else:
-                node_ops = [(None, None, None, -numbering[frozenset(tree)])]
+                next_state = -numbering[frozenset(tree)]
+                node_ops = [(None, None, None, next_state, next_state)]
         else:
             node_ops = [tree]
             todo = [0]
@@ -562,7 +719,8 @@ def build_states(nfa, dfa, numbering):
                     node_ops.append(tree.if_false)
 
                 namespace, localname = tree.test.name
-                node_ops[i] = (namespace, localname, None, if_true, if_false)
+                node_ops[i] = (namespace, localname, tree.test.function,
+                               if_true, if_false)
                 #print "Added", node_ops[i]
                 if if_false > 0:
                     todo.append(if_false)
@@ -653,6 +811,9 @@ class RuleMachineHandler(object):
 
     def startDocument(self,node):
         self.stack = [0]
+        # per open element, the position counters for its children
+        # (created when a positional predicate is first evaluated)
+        self.counters = [None]
         #dump_machine_states(self.machine_states)
 
     def startElementNS(self, node, name, qname, attrs):
@@ -661,6 +822,7 @@ class RuleMachineHandler(object):
         if state == -1:
             #print "goto -1"
             self.stack.append(-1)
+            self.counters.append(None)
             return
         
         element_ops = self.machine_states[state][1]
@@ -668,22 +830,35 @@ class RuleMachineHandler(object):
             # This was a valid target, but there's nothing leading off from it
             #print "GOTO -1"
             self.stack.append(-1)
+            self.counters.append(None)
             return
         
         namespace, localname = name
+        positions = None
         i = 0
         while 1:
             ns, ln, test_function, if_true, if_false = element_ops[i]
-            assert test_function is None
             if ((ns is None or ns == namespace) and
                 (ln is None or ln == localname)):
-                i = if_true
+                if test_function is None:
+                    i = if_true
+                else:
+                    if positions is None:
+                        counters = self.counters[-1]
+                        if counters is None:
+                            counters = self.counters[-1] = {}
+                        positions = {}
+                    if test_function(attrs, counters, positions):
+                        i = if_true
+                    else:
+                        i = if_false
             else:
                 i = if_false
             if i == 0:
                 # dead-end; no longer part of the DFA and the
                 # 0 node is defined to have no attributes
                 self.stack.append(-1)
+                self.counters.append(None)
                 return
             if i < 0:
                 next_state = -i
@@ -692,6 +867,7 @@ class RuleMachineHandler(object):
 
         #print "GoTo", next_state
         self.stack.append(next_state)
+        self.counters.append(None)
 
         handlers = self.machine_states[next_state][0]
         for handler in handlers:
@@ -718,6 +894,7 @@ class RuleMachineHandler(object):
     def endElementNS(self, node, name, qname):
         #print "endElementNS", node, name, qname
         last_state = self.stack.pop()
+        del self.counters[-1]
         if last_state == -1:
             return
         handlers = self.machine_states[last_state][0]
@@ -0,0 +1,927 @@
+#define PY_SSIZE_T_CLEAN
+#include "domlette_interface.h"
+#include "container.h"
+#include "binary.h"
+
+/** Implementation notes:
+ *
+ * The binary tree format is a flat image of a Domlette tree that can be
+ * restored without going through the XML parser.  It is laid out as:
+ *
+ *    header    6 words: magic, byte order mark, format version, string
+ *              count, size of the string table (in bytes) and size of
+ *              the node stream (in bytes)
+ *    strings   the string table; `count` entries of the form
+ *              <length><UTF-8 bytes><padding>
+ *    nodes     the node stream; one record per node in document order
+ *              (pre-order), each record starting with its node type
+ *
+ * Every integer is a native 32-bit word and every string or text value is
+ * stored as UTF-8 padded to a word boundary, so each section (and each
+ * record within it) is word aligned.  The image carries no pointers, which
+ * means it can be written to a file and later mmap'ed read-only by any
+ * number of processes on machines with the same byte order; images with a
+ * foreign byte order are rejected on load.
+ *
+ * Names, namespace URIs, prefixes and the document's identifiers are
+ * written once to the string table and referred to by index (index 0 is
+ * reserved for None).  Loading creates a single string object for each
+ * entry, so all nodes share the same name objects just as they do when
+ * produced by the Expat reader.  Character data (text, comments, attribute
+ * values and processing instruction data) is written inline, prefixed by
+ * its length.
+ *
+ * Node records:
+ *
+ *    ENTITY    documentURI, publicId, systemId, #unparsed, #children,
+ *              #unparsed * (name, systemId)
+ *    ELEMENT   namespaceURI, qname, localName, #namespaces, #attributes,
+ *              #children, #namespaces * (prefix, namespaceURI),
+ *              #attributes * (namespaceURI, qname, localName, type, <value>)
+ *    TEXT      <data>
+ *    COMMENT   <data>
+ *    PI        target, <data>
+ *
+ * The children of a container immediately follow its record.  The loader
+ * builds the tree the same way the builder does: each container collects
+ * its children in a reusable working array (sized exactly from the child
+ * count in its record) via _Container_FastAppend() and is then frozen.
+ */
+
+typedef unsigned int BinaryWord;
+
+#define BINARY_MAGIC      0x54424441  /* "ADBT" when little-endian */
+#define BINARY_BYTE_ORDER 0x01020304
+#define BINARY_VERSION    1
+#define BINARY_HEADER_WORDS 6
+
+typedef enum {
+  BINARY_ENTITY = 1,
+  BINARY_ELEMENT,
+  BINARY_TEXT,
+  BINARY_COMMENT,
+  BINARY_PROCESSING_INSTRUCTION,
+} BinaryNodeType;
+
+#define WORD_SIZE ((Py_ssize_t) sizeof(BinaryWord))
+#define PADDED_SIZE(n) (((n) + (WORD_SIZE - 1)) & ~(WORD_SIZE - 1))
+
+static PyObject *gc_enable_function;
+static PyObject *gc_disable_function;
+static PyObject *gc_isenabled_function;
+static PyObject *empty_args_tuple;
+
+/** Writer *************************************************************/
+
+#define INITIAL_BUFFER_SIZE 4096
+
+typedef struct {
+  /* maps each string to its (1-based) index in the string table */
+  PyObject *string_index;
+  /* the strings in table order */
+  PyObject *strings;
+  /* the node stream */
+  char *buffer;
+  Py_ssize_t size;
+  Py_ssize_t allocated;
+} BinaryWriter;
+
+Py_LOCAL_INLINE(int)
+writer_reserve(BinaryWriter *writer, Py_ssize_t size)
+{
+  Py_ssize_t new_allocated = writer->allocated;
+  char *buffer;
+
+  if (writer->size + size <= new_allocated)
+    return 0;
+
+  while (new_allocated < writer->size + size) {
+    if (new_allocated > PY_SSIZE_T_MAX >> 1) {
+      PyErr_NoMemory();
+      return -1;
+    }
+    new_allocated <<= 1;
+  }
+  buffer = writer->buffer;
+  if (PyMem_Resize(buffer, char, new_allocated) == NULL) {
+    PyErr_NoMemory();
+    return -1;
+  }
+  writer->buffer = buffer;
+  writer->allocated = new_allocated;
+  return 0;
+}
+
+Py_LOCAL_INLINE(int)
+write_word(BinaryWriter *writer, Py_ssize_t value)
+{
+  BinaryWord word = (BinaryWord) value;
+  if ((Py_ssize_t) word != value) {
+    PyErr_SetString(PyExc_OverflowError,
+                    "value too large for binary tree format");
+    return -1;
+  }
+  if (writer_reserve(writer, WORD_SIZE) < 0)
+    return -1;
+  memcpy(writer->buffer + writer->size, &word, WORD_SIZE);
+  writer->size += WORD_SIZE;
+  return 0;
+}
+
+/* Writes a length-prefixed run of UTF-8 encoded `text` to `writer`. */
+Py_LOCAL_INLINE(int)
+write_utf8(BinaryWriter *writer, PyObject *text)
+{
+  PyObject *bytes;
+  Py_ssize_t size, padded;
+
+  bytes = PyUnicode_AsUTF8String(text);
+  if (bytes == NULL)
+    return -1;
+  size = PyString_GET_SIZE(bytes);
+  padded = PADDED_SIZE(size);
+  if (write_word(writer, size) < 0 || writer_reserve(writer, padded) < 0) {
+    Py_DECREF(bytes);
+    return -1;
+  }
+  memcpy(writer->buffer + writer->size, PyString_AS_STRING(bytes), size);
+  memset(writer->buffer + writer->size + size, 0, padded - size);
+  writer->size += padded;
+  Py_DECREF(bytes);
+  return 0;
+}
+
+/* Writes a run of character data to the node stream. */
+Py_LOCAL_INLINE(int)
+write_text(BinaryWriter *writer, PyObject *text)
+{
+  if (!XmlString_Check(text)) {
+    PyErr_Format(PyExc_TypeError,
+                 "cannot serialize character data of type '%s'",
+                 text->ob_type->tp_name);
+    return -1;
+  }
+  return write_utf8(writer, text);
+}
+
+/* Writes a reference to `string` in the string table, adding the string
+ * to the table if this is its first use.
+ */
+Py_LOCAL_INLINE(int)
+write_string(BinaryWriter *writer, PyObject *string)
+{
+  PyObject *index;
+  Py_ssize_t value;
+
+  if (string == Py_None)
+    return write_word(writer, 0);
+  if (!XmlString_Check(string)) {
+    PyErr_Format(PyExc_TypeError, "cannot serialize names of type '%s'",
+                 string->ob_type->tp_name);
+    return -1;
+  }
+  index = PyDict_GetItem(writer->string_index, string);
+  if (index != NULL)
+    return write_word(writer, PyInt_AS_LONG(index));
+
+  value = PyList_GET_SIZE(writer->strings) + 1;
+  index = PyInt_FromSsize_t(value);
+  if (index == NULL)
+    return -1;
+  if (PyDict_SetItem(writer->string_index, string, index) < 0) {
+    Py_DECREF(index);
+    return -1;
+  }
+  Py_DECREF(index);
+  if (PyList_Append(writer->strings, string) < 0)
+    return -1;
+  return write_word(writer, value);
+}
+
+Py_LOCAL_INLINE(int)
+write_entity(BinaryWriter *writer, EntityObject *entity)
+{
+  PyObject *unparsed_entities = Entity_GET_UNPARSED_ENTITIES(entity);
+  PyObject *name, *system_id;
+  Py_ssize_t pos;
+
+  if (write_word(writer, BINARY_ENTITY) < 0 ||
+      write_string(writer, Entity_GET_DOCUMENT_URI(entity)) < 0 ||
+      write_string(writer, Entity_GET_PUBLIC_ID(entity)) < 0 ||
+      write_string(writer, Entity_GET_SYSTEM_ID(entity)) < 0 ||
+      write_word(writer, PyDict_Size(unparsed_entities)) < 0 ||
+      write_word(writer, Container_GET_COUNT(entity)) < 0)
+    return -1;
+  pos = 0;
+  while (PyDict_Next(unparsed_entities, &pos, &name, &system_id)) {
+    if (write_string(writer, name) < 0 ||
+        write_string(writer, system_id) < 0)
+      return -1;
+  }
+  return 0;
+}
+
+Py_LOCAL_INLINE(int)
+write_element(BinaryWriter *writer, ElementObject *element)
+{
+  PyObject *namespaces = Element_NAMESPACES(element);
+  PyObject *attributes = Element_ATTRIBUTES(element);
+  NamespaceObject *namespace;
+  AttrObject *attr;
+  Py_ssize_t pos;
+
+  if (write_word(writer, BINARY_ELEMENT) < 0 ||
+      write_string(writer, Element_NAMESPACE_URI(element)) < 0 ||
+      write_string(writer, Element_QNAME(element)) < 0 ||
+      write_string(writer, Element_LOCAL_NAME(element)) < 0 ||
+      write_word(writer, namespaces ? NamespaceMap_GET_SIZE(namespaces) : 0) < 0 ||
+      write_word(writer, attributes ? AttributeMap_GET_SIZE(attributes) : 0) < 0 ||
+      write_word(writer, Container_GET_COUNT(element)) < 0)
+    return -1;
+  if (namespaces) {
+    pos = 0;
+    while ((namespace = NamespaceMap_Next(namespaces, &pos))) {
+      if (write_string(writer, Namespace_GET_NAME(namespace)) < 0 ||
+          write_string(writer, Namespace_GET_VALUE(namespace)) < 0)
+        return -1;
+    }
+  }
+  if (attributes) {
+    pos = 0;
+    while ((attr = AttributeMap_Next(attributes, &pos))) {
+      if (write_string(writer, Attr_GET_NAMESPACE_URI(attr)) < 0 ||
+          write_string(writer, Attr_GET_QNAME(attr)) < 0 ||
+          write_string(writer, Attr_GET_LOCAL_NAME(attr)) < 0 ||
+          write_word(writer, Attr_GET_TYPE(attr)) < 0 ||
+          write_text(writer, Attr_GET_VALUE(attr)) < 0)
+        return -1;
+    }
+  }
+  return 0;
+}
+
+/* Writes the record for `node`; the records of its children (if any) are
+ * left to the caller. */
+Py_LOCAL_INLINE(int)
+write_record(BinaryWriter *writer, NodeObject *node)
+{
+  if (Element_Check(node)) {
+    return write_element(writer, Element(node));
+  } else if (Text_Check(node)) {
+    if (write_word(writer, BINARY_TEXT) < 0)
+      return -1;
+    return write_text(writer, Text_GET_VALUE(node));
+  } else if (Comment_Check(node)) {
+    if (write_word(writer, BINARY_COMMENT) < 0)
+      return -1;
+    return write_text(writer, Comment_GET_VALUE(node));
+  } else if (ProcessingInstruction_Check(node)) {
+    if (write_word(writer, BINARY_PROCESSING_INSTRUCTION) < 0 ||
+        write_string(writer, ProcessingInstruction_GET_TARGET(node)) < 0)
+      return -1;
+    return write_text(writer, ProcessingInstruction_GET_DATA(node));
+  } else if (Entity_Check(node)) {
+    return write_entity(writer, Entity(node));
+  }
+  PyErr_Format(PyExc_TypeError, "cannot serialize '%s' objects",
+               node->ob_type->tp_name);
+  return -1;
+}
+
+typedef struct {
+  NodeObject *node;
+  /* index of the next child to be written */
+  Py_ssize_t next;
+} WriterFrame;
+
+/* Writes the records for the subtree rooted at `node` in document order.
+ * The containers being written are kept on an explicit stack (as the
+ * reader does), so the depth of the tree is not limited by the C stack. */
+static int write_tree(BinaryWriter *writer, NodeObject *node)
+{
+  WriterFrame *frames, *frame;
+  Py_ssize_t depth, allocated;
+
+  if (write_record(writer, node) < 0)
+    return -1;
+  if (!Container_Check(node))
+    return 0;
+
+  allocated = 16;
+  frames = PyMem_New(WriterFrame, allocated);
+  if (frames == NULL) {
+    PyErr_NoMemory();
+    return -1;
+  }
+  frames[0].node = node;
+  frames[0].next = 0;
+  depth = 1;
+  while (depth > 0) {
+    frame = &frames[depth - 1];
+    if (frame->next == Container_GET_COUNT(frame->node)) {
+      depth--;
+      continue;
+    }
+    node = Container_GET_CHILD(frame->node, frame->next++);
+    if (write_record(writer, node) < 0) {
+      PyMem_Free(frames);
+      return -1;
+    }
+    if (Container_Check(node)) {
+      if (depth == allocated) {
+        WriterFrame *resized = frames;
+        if (PyMem_Resize(resized, WriterFrame, allocated << 1) == NULL) {
+          PyMem_Free(frames);
+          PyErr_NoMemory();
+          return -1;
+        }
+        frames = resized;
+        allocated <<= 1;
+      }
+      frames[depth].node = node;
+      frames[depth].next = 0;
+      depth++;
+    }
+  }
+  PyMem_Free(frames);
+  return 0;
+}
+
+/* Assembles the header, string table and node stream into a new string. */
+Py_LOCAL_INLINE(PyObject *)
+writer_finish(BinaryWriter *writer)
+{
+  BinaryWord header[BINARY_HEADER_WORDS];
+  PyObject *result;
+  Py_ssize_t i, count, nodes_size;
+  char *p;
+
+  /* the string table is written at the end of the node stream and then
+   * moved in front of it */
+  nodes_size = writer->size;
+  count = PyList_GET_SIZE(writer->strings);
+  for (i = 0; i < count; i++) {
+    if (write_utf8(writer, PyList_GET_ITEM(writer->strings, i)) < 0)
+      return NULL;
+  }
+  header[0] = BINARY_MAGIC;
+  header[1] = BINARY_BYTE_ORDER;
+  header[2] = BINARY_VERSION;
+  header[3] = (BinaryWord) count;
+  header[4] = (BinaryWord) (writer->size - nodes_size);
+  header[5] = (BinaryWord) nodes_size;
+  if ((Py_ssize_t) header[4] != writer->size - nodes_size) {
+    PyErr_SetString(PyExc_OverflowError,
+                    "string table too large for binary tree format");
+    return NULL;
+  }
+
+  result = PyString_FromStringAndSize(NULL, sizeof(header) + writer->size);
+  if (result == NULL)
+    return NULL;
+  p = PyString_AS_STRING(result);
+  memcpy(p, header, sizeof(header));
+  p += sizeof(header);
+  memcpy(p, writer->buffer + nodes_size, writer->size - nodes_size);
+  p += writer->size - nodes_size;
+  memcpy(p, writer->buffer, nodes_size);
+  return result;
+}
+
+PyObject *Domlette_Dumps(PyObject *self, PyObject *args)
+{
+  NodeObject *node;
+  BinaryWriter writer;
+  PyObject *result = NULL;
+
+  if (!PyArg_ParseTuple(args, "O!:dumps", &DomletteNode_Type, &node))
+    return NULL;
+
+  if (!Entity_Check(node) && !Element_Check(node)) {
+    PyErr_Format(PyExc_TypeError, "dumps() argument must be %s or %s, not %s",
+                 DomletteEntity_Type.tp_name, DomletteElement_Type.tp_name,
+                 node->ob_type->tp_name);
+    return NULL;
+  }
+
+  memset(&writer, 0, sizeof(BinaryWriter));
+  writer.string_index = PyDict_New();
+  if (writer.string_index == NULL)
+    return NULL;
+  writer.strings = PyList_New(0);
+  if (writer.strings == NULL)
+    goto finally;
+  writer.buffer = PyMem_New(char, INITIAL_BUFFER_SIZE);
+  if (writer.buffer == NULL) {
+    PyErr_NoMemory();
+    goto finally;
+  }
+  writer.allocated = INITIAL_BUFFER_SIZE;
+
+  if (write_tree(&writer, node) == 0)
+    result = writer_finish(&writer);
+
+finally:
+  Py_DECREF(writer.string_index);
+  Py_XDECREF(writer.strings);
+  PyMem_Free(writer.buffer);
+  return result;
+}
+
+/** Reader *************************************************************/
+
+typedef struct {
+  NodeObject *node;
+  /* number of children still to be read */
+  BinaryWord remaining;
+  /* Working children array; reused by each container loaded at this depth
+   * (see the notes on Context in builder.c).
+   */
+  NodeObject **children;
+  Py_ssize_t children_allocated;
+} BinaryFrame;
+
+typedef struct {
+  const char *ptr;
+  const char *end;
+  PyObject **strings;
+  BinaryWord nstrings;
+  BinaryFrame *frames;
+  Py_ssize_t depth;
+  Py_ssize_t frames_allocated;
+} BinaryReader;
+
+Py_LOCAL_INLINE(int)
+corrupt_image(void)
+{
+  PyErr_SetString(PyExc_ValueError, "truncated or corrupt binary tree");
+  return -1;
+}
+
+Py_LOCAL_INLINE(int)
+read_word(BinaryReader *reader, BinaryWord *value)
+{
+  if (reader->end - reader->ptr < (Py_ssize_t) WORD_SIZE)
+    return corrupt_image();
+  memcpy(value, reader->ptr, WORD_SIZE);
+  reader->ptr += WORD_SIZE;
+  return 0;
+}
+
+/* Returns a new reference to the unicode object for the next run of
+ * character data in the image.
+ */
+Py_LOCAL_INLINE(PyObject *)
+read_text(BinaryReader *reader)
+{
+  BinaryWord length;
+  Py_ssize_t size;
+  PyObject *text;
+
+  if (read_word(reader, &length) < 0)
+    return NULL;
+  size = (Py_ssize_t) length;
+  if (size < 0 || reader->end - reader->ptr < PADDED_SIZE(size)) {
+    corrupt_image();
+    return NULL;
+  }
+  text = PyUnicode_DecodeUTF8(reader->ptr, size, "strict");
+  reader->ptr += PADDED_SIZE(size);
+  return text;
+}
+
+/* Returns a borrowed reference to the string table entry named by the next
+ * word in the image.
+ */
+Py_LOCAL_INLINE(PyObject *)
+read_string(BinaryReader *reader, int nullable)
+{
+  BinaryWord index;
+
+  if (read_word(reader, &index) < 0)
+    return NULL;
+  if (index == 0) {
+    if (nullable)
+      return Py_None;
+  } else if (index <= reader->nstrings) {
+    return reader->strings[index - 1];
+  }
+  corrupt_image();
+  return NULL;
+}
+
+Py_LOCAL_INLINE(int)
+read_string_table(BinaryReader *reader, BinaryWord count)
+{
+  BinaryWord i;
+
+  if ((size_t) count > PY_SSIZE_T_MAX / sizeof(PyObject *))
+    return corrupt_image();
+  reader->strings = PyMem_New(PyObject *, count ? count : 1);
+  if (reader->strings == NULL) {
+    PyErr_NoMemory();
+    return -1;
+  }
+  for (i = 0; i < count; i++) {
+    PyObject *string = read_text(reader);
+    if (string == NULL)
+      return -1;
+    reader->strings[reader->nstrings++] = string;
+  }
+  return 0;
+}
+
+/* Makes room for one more frame and sets its working array up to hold at
+ * least `count` children without growing.
+ */
+Py_LOCAL_INLINE(int)
+push_frame(BinaryReader *reader, NodeObject *node, BinaryWord count)
+{
+  BinaryFrame *frame;
+
+  if (reader->depth == reader->frames_allocated) {
+    Py_ssize_t new_allocated = reader->frames_allocated + 16;
+    BinaryFrame *frames = reader->frames;
+    if (PyMem_Resize(frames, BinaryFrame, new_allocated) == NULL) {
+      PyErr_NoMemory();
+      return -1;
+    }
+    memset(frames + reader->frames_allocated, 0,
+           sizeof(BinaryFrame) * (new_allocated - reader->frames_allocated));
+    reader->frames = frames;
+    reader->frames_allocated = new_allocated;
+  }
+  frame = &reader->frames[reader->depth];
+
+  /* _Container_FastAppend() grows the array once `count` reaches
+   * `allocated`, so keep one spare slot */
+  if (frame->children_allocated <= (Py_ssize_t) count) {
+    NodeObject **children = frame->children;
+    Py_ssize_t new_allocated = (Py_ssize_t) count + 1;
+    if (PyMem_Resize(children, NodeObject *, new_allocated) == NULL) {
+      PyErr_NoMemory();
+      return -1;
+    }
+    frame->children = children;
+    frame->children_allocated = new_allocated;
+  }
+  _Container_SetWorkingChildren(node, frame->children,
+                                frame->children_allocated);
+  frame->node = node;
+  frame->remaining = count;
+  reader->depth++;
+  return 0;
+}
+
+/* Freezes the children of the current frame's node and pops the frame.
+ * Returns the (owned) node.
+ */
+Py_LOCAL_INLINE(NodeObject *)
+pop_frame(BinaryReader *reader)
+{
+  BinaryFrame *frame = &reader->frames[reader->depth - 1];
+  NodeObject *node = frame->node;
+
+  frame->children = _Container_GetWorkingChildren(node,
+                                                  &frame->children_allocated);
+  switch (_Container_FreezeChildren(node)) {
+    case 0:
+      break;
+    case -1:
+      /* frozen, but an event handler failed; the node is done with the
+       * working array */
+      frame->node = NULL;
+      reader->depth--;
+      Py_DECREF(node);
+    default:
+      return NULL;
+  }
+  frame->node = NULL;
+  reader->depth--;
+  return node;
+}
+
+Py_LOCAL_INLINE(EntityObject *)
+read_entity(BinaryReader *reader, BinaryWord *count)
+{
+  EntityObject *entity;
+  PyObject *document_uri, *public_id, *system_id, *name, *value;
+  BinaryWord unparsed = 0;
+
+  if ((document_uri = read_string(reader, 1)) == NULL ||
+      (public_id = read_string(reader, 1)) == NULL ||
+      (system_id = read_string(reader, 1)) == NULL ||
+      read_word(reader, &unparsed) < 0 ||
+      read_word(reader, count) < 0)
+    return NULL;
+
+  entity = Entity_New(document_uri);
+  if (entity == NULL)
+    return NULL;
+  Py_INCREF(public_id);
+  Py_DECREF(Entity_GET_PUBLIC_ID(entity));
+  Entity_SET_PUBLIC_ID(entity, public_id);
+  Py_INCREF(system_id);
+  Py_DECREF(Entity_GET_SYSTEM_ID(entity));
+  Entity_SET_SYSTEM_ID(entity, system_id);
+
+  while (unparsed-- > 0) {
+    if ((name = read_string(reader, 0)) == NULL ||
+        (value = read_string(reader, 1)) == NULL ||
+        PyDict_SetItem(Entity_GET_UNPARSED_ENTITIES(entity), name, value) < 0) {
+      Py_DECREF(entity);
+      return NULL;
+    }
+  }
+  return entity;
+}
+
+Py_LOCAL_INLINE(ElementObject *)
+read_element(BinaryReader *reader, BinaryWord *count)
+{
+  ElementObject *element;
+  PyObject *namespace_uri, *qname, *local_name, *prefix, *value;
+  BinaryWord namespaces = 0, attributes = 0, type = 0;
+
+  if ((namespace_uri = read_string(reader, 1)) == NULL ||
+      (qname = read_string(reader, 0)) == NULL ||
+      (local_name = read_string(reader, 0)) == NULL ||
+      read_word(reader, &namespaces) < 0 ||
+      read_word(reader, &attributes) < 0 ||
+      read_word(reader, count) < 0)
+    return NULL;
+
+  element = Element_New(namespace_uri, qname, local_name);
+  if (element == NULL)
+    return NULL;
+
+  while (namespaces-- > 0) {
+    NamespaceObject *node;
+    if ((prefix = read_string(reader, 1)) == NULL ||
+        (namespace_uri = read_string(reader, 0)) == NULL) {
+      Py_DECREF(element);
+      return NULL;
+    }
+    node = Element_AddNamespace(element, prefix, namespace_uri);
+    if (node == NULL) {
+      Py_DECREF(element);
+      return NULL;
+    }
+    Py_DECREF(node);
+  }
+
+  while (attributes-- > 0) {
+    AttrObject *node;
+    if ((namespace_uri = read_string(reader, 1)) == NULL ||
+        (qname = read_string(reader, 0)) == NULL ||
+        (local_name = read_string(reader, 0)) == NULL ||
+        read_word(reader, &type) < 0 ||
+        (value = read_text(reader)) == NULL) {
+      Py_DECREF(element);
+      return NULL;
+    }
+    if (type > ATTRIBUTE_TYPE_ENUMERATION) {
+      Py_DECREF(value);
+      Py_DECREF(element);
+      corrupt_image();
+      return NULL;
+    }
+    node = Element_AddAttribute(element, namespace_uri, qname, local_name,
+                                value);
+    Py_DECREF(value);
+    if (node == NULL) {
+      Py_DECREF(element);
+      return NULL;
+    }
+    Attr_SET_TYPE(node, (AttributeType) type);
+    Py_DECREF(node);
+  }
+  return element;
+}
+
+/* Reads the next node record.  For containers, `count` is set to the number
+ * of child records that follow; otherwise it is left unchanged.
+ */
+Py_LOCAL_INLINE(NodeObject *)
+read_node(BinaryReader *reader, BinaryWord *count)
+{
+  BinaryWord type;
+  PyObject *target, *data;
+  NodeObject *node;
+
+  if (read_word(reader, &type) < 0)
+    return NULL;
+  switch (type) {
+  case BINARY_ENTITY:
+    return (NodeObject *) read_entity(reader, count);
+  case BINARY_ELEMENT:
+    return (NodeObject *) read_element(reader, count);
+  case BINARY_TEXT:
+    if ((data = read_text(reader)) == NULL)
+      return NULL;
+    node = (NodeObject *) Text_New(data);
+    break;
+  case BINARY_COMMENT:
+    if ((data = read_text(reader)) == NULL)
+      return NULL;
+    node = (NodeObject *) Comment_New(data);
+    break;
+  case BINARY_PROCESSING_INSTRUCTION:
+    if ((target = read_string(reader, 0)) == NULL ||
+        (data = read_text(reader)) == NULL)
+      return NULL;
+    node = (NodeObject *) ProcessingInstruction_New(target, data);
+    break;
+  default:
+    corrupt_image();
+    return NULL;
+  }
+  Py_DECREF(data);
+  return node;
+}
+
+static NodeObject *read_tree(BinaryReader *reader)
+{
+  NodeObject *node, *parent;
+  BinaryFrame *frame;
+  BinaryWord count;
+
+  node = read_node(reader, &count);
+  if (node == NULL)
+    return NULL;
+  if (!Container_Check(node))
+    return node;
+  if (push_frame(reader, node, count) < 0) {
+    Py_DECREF(node);
+    return NULL;
+  }
+
+  while (1) {
+    frame = &reader->frames[reader->depth - 1];
+    if (frame->remaining == 0) {
+      node = pop_frame(reader);
+      if (node == NULL)
+        return NULL;
+      if (reader->depth == 0)
+        return node;
+      parent = reader->frames[reader->depth - 1].node;
+    } else {
+      frame->remaining--;
+      parent = frame->node;
+      node = read_node(reader, &count);
+      if (node == NULL)
+        return NULL;
+      if (Entity_Check(node)) {
+        Py_DECREF(node);
+        corrupt_image();
+        return NULL;
+      }
+      if (Element_Check(node)) {
+        /* the element is added to its parent once its children are read */
+        if (push_frame(reader, node, count) < 0) {
+          Py_DECREF(node);
+          return NULL;
+        }
+        continue;
+      }
+    }
+    /* _Container_FastAppend() steals the reference to `node` */
+    if (_Container_FastAppend(parent, node) < 0) {
+      Py_DECREF(node);
+      return NULL;
+    }
+  }
+}
+
+Py_LOCAL_INLINE(void)
+reader_clear(BinaryReader *reader)
+{
+  Py_ssize_t i;
+
+  /* Release any partially built containers (only set on error).  As with
+   * Context_Del() in builder.c, the working array has to be reclaimed
+   * from the node before it is released. */
+  while (reader->depth > 0) {
+    BinaryFrame *frame = &reader->frames[--reader->depth];
+    frame->children =
+      _Container_GetWorkingChildren(frame->node, &frame->children_allocated);
+    Py_DECREF(frame->node);
+  }
+  for (i = 0; i < reader->frames_allocated; i++) {
+    PyMem_Free(reader->frames[i].children);
+  }
+  PyMem_Free(reader->frames);
+  while (reader->nstrings > 0) {
+    reader->nstrings--;
+    Py_DECREF(reader->strings[reader->nstrings]);
+  }
+  PyMem_Free(reader->strings);
+}
+
+PyObject *Domlette_Loads(PyObject *self, PyObject *args)
+{
+  PyObject *buffer, *result;
+  const void *data;
+  Py_ssize_t length;
+  BinaryReader reader;
+  BinaryWord header[BINARY_HEADER_WORDS];
+  int gc_enabled;
+  NodeObject *node;
+
+  if (!PyArg_ParseTuple(args, "O:loads", &buffer))
+    return NULL;
+  if (PyObject_AsReadBuffer(buffer, &data, &length) < 0)
+    return NULL;
+
+  if (length >= (Py_ssize_t) sizeof(header))
+    memcpy(header, data, sizeof(header));
+  if (length < (Py_ssize_t) sizeof(header) || header[0] != BINARY_MAGIC) {
+    PyErr_SetString(PyExc_ValueError, "not a binary tree image");
+    return NULL;
+  }
+  if (header[1] != BINARY_BYTE_ORDER) {
+    PyErr_SetString(PyExc_ValueError,
+                    "binary tree image has a foreign byte order");
+    return NULL;
+  }
+  if (header[2] != BINARY_VERSION) {
+    PyErr_Format(PyExc_ValueError,
+                 "unsupported binary tree format version %d", (int) header[2]);
+    return NULL;
+  }
+  if ((size_t) length != sizeof(header) + (size_t) header[4] + header[5]) {
+    corrupt_image();
+    return NULL;
+  }
+  memset(&reader, 0, sizeof(BinaryReader));
+  reader.ptr = (const char *) data + sizeof(header);
+  reader.end = (const char *) data + length;
+
+  /* Disable GC (if enabled) while building the tree */
+  result = PyObject_Call(gc_isenabled_function, empty_args_tuple, NULL);
+  if (result == NULL)
+    return NULL;
+  gc_enabled = PyObject_IsTrue(result);
+  Py_DECREF(result);
+  if (gc_enabled) {
+    result = PyObject_Call(gc_disable_function, empty_args_tuple, NULL);
+    if (result == NULL)
+      return NULL;
+    Py_DECREF(result);
+  }
+
+  node = NULL;
+  if (read_string_table(&reader, header[3]) == 0) {
+    if (reader.ptr != (const char *) data + sizeof(header) + header[4])
+      corrupt_image();
+    else if ((node = read_tree(&reader)) != NULL && reader.ptr != reader.end) {
+      Py_CLEAR(node);
+      corrupt_image();
+    }
+  }
+  reader_clear(&reader);
+
+  if (gc_enabled) {
+    result = PyObject_Call(gc_enable_function, empty_args_tuple, NULL);
+    if (result == NULL) {
+      Py_XDECREF(node);
+      return NULL;
+    }
+    Py_DECREF(result);
+  }
+  return (PyObject *) node;
+}
+
+/** Module Interface **************************************************/
+
+int DomletteBinary_Init(PyObject *module)
+{
+  PyObject *import;
+
+  empty_args_tuple = PyTuple_New(0);
+  if (empty_args_tuple == NULL) return -1;
+
+  import = PyImport_ImportModule("gc");
+  if (import == NULL) return -1;
+#define GET_GC_FUNC(NAME)                                       \
+  gc_##NAME##_function = PyObject_GetAttrString(import, #NAME); \
+  if (gc_##NAME##_function == NULL) {                           \
+    Py_DECREF(import);                                          \
+    return -1;                                                  \
+  }
+  GET_GC_FUNC(enable);
+  GET_GC_FUNC(disable);
+  GET_GC_FUNC(isenabled);
+  Py_DECREF(import);
+#undef GET_GC_FUNC
+
+  return 0;
+}
+
+void DomletteBinary_Fini(void)
+{
+  Py_DECREF(empty_args_tuple);
+  Py_DECREF(gc_enable_function);
+  Py_DECREF(gc_disable_function);
+  Py_DECREF(gc_isenabled_function);
+}
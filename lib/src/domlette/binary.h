@@ -0,0 +1,25 @@
+#ifndef DOMLETTE_BINARY_H
+#define DOMLETTE_BINARY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Python.h"
+
+#ifdef Domlette_BUILDING_MODULE
+
+  PyObject *Domlette_Dumps(PyObject *self, PyObject *args);
+
+  PyObject *Domlette_Loads(PyObject *self, PyObject *args);
+
+  int DomletteBinary_Init(PyObject *module);
+  void DomletteBinary_Fini(void);
+
+#endif /* Domlette_BUILDING_MODULE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DOMLETTE_BINARY_H */
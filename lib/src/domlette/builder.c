@@ -297,6 +297,8 @@ load_factory(PyObject *obj, char *name, PyTypeObject *type, PyObject **pslot)
   PyObject *factory = PyObject_GetAttrString(obj, name);
   if (factory == NULL)
     return 0;
+  /* the slot is already populated when parsing multiple records */
+  Py_CLEAR(*pslot);
   if (factory == (PyObject *)type)
     Py_DECREF(factory);
   else
@@ -925,6 +927,183 @@ PyObject *Domlette_ParseFragment(PyObject *self, PyObject *args, PyObject *kw)
                        namespaces,rule_handler);
 }
 
+/** Record parsing ****************************************************/
+
+/* Parses a stream of back-to-back documents, one document per call to
+ * next().  The same reader (and Expat parser) is used for every record.
+ */
+
+typedef struct {
+  PyObject_HEAD
+  ParserState *state;
+  PyObject *source;             /* until the first record is parsed */
+  PyObject *separator;
+} RecordIterObject;
+
+static PyTypeObject RecordIter_Type;
+
+static void record_iter_finish(RecordIterObject *self)
+{
+  if (self->state) {
+    ExpatReader_Del(self->state->reader);
+    ParserState_Del(self->state);
+    self->state = NULL;
+  }
+  Py_CLEAR(self->source);
+}
+
+static void record_iter_dealloc(RecordIterObject *self)
+{
+  record_iter_finish(self);
+  Py_CLEAR(self->separator);
+  PyObject_Del(self);
+}
+
+static PyObject *record_iter_next(RecordIterObject *self)
+{
+  ParserState *state = self->state;
+  PyObject *result;
+  int gc_enabled;
+  ExpatStatus status;
+
+  if (state == NULL)
+    return NULL;
+
+  /* Disable GC (if enabled) while building the DOM tree */
+  result = PyObject_Call(gc_isenabled_function, empty_args_tuple, NULL);
+  if (result == NULL)
+    return NULL;
+  gc_enabled = PyObject_IsTrue(result);
+  Py_DECREF(result);
+  if (gc_enabled) {
+    result = PyObject_Call(gc_disable_function, empty_args_tuple, NULL);
+    if (result == NULL)
+      return NULL;
+    Py_DECREF(result);
+  }
+
+  if (self->source) {
+    status = ExpatReader_ParseRecords(state->reader, self->source,
+                                      self->separator);
+    Py_CLEAR(self->source);
+  } else {
+    status = ExpatReader_NextRecord(state->reader);
+  }
+
+  if (gc_enabled) {
+    result = PyObject_Call(gc_enable_function, empty_args_tuple, NULL);
+    if (result == NULL) {
+      record_iter_finish(self);
+      return NULL;
+    }
+    Py_DECREF(result);
+  }
+
+  if (status == EXPAT_STATUS_SUSPENDED) {
+    /* a complete record; as in builder_parse(), the reference returned is
+     * the one held by the (now free) document context */
+    result = (PyObject *)state->owner_document;
+    Py_CLEAR(state->owner_document);
+    return result;
+  }
+  /* end of input (OK) or error */
+  record_iter_finish(self);
+  return NULL;
+}
+
+static PyTypeObject RecordIter_Type = {
+  /* PyObject_HEAD     */ PyObject_HEAD_INIT(NULL)
+  /* ob_size           */ 0,
+  /* tp_name           */ "record-iterator",
+  /* tp_basicsize      */ sizeof(RecordIterObject),
+  /* tp_itemsize       */ 0,
+  /* tp_dealloc        */ (destructor) record_iter_dealloc,
+  /* tp_print          */ (printfunc) 0,
+  /* tp_getattr        */ (getattrfunc) 0,
+  /* tp_setattr        */ (setattrfunc) 0,
+  /* tp_compare        */ (cmpfunc) 0,
+  /* tp_repr           */ (reprfunc) 0,
+  /* tp_as_number      */ (PyNumberMethods *) 0,
+  /* tp_as_sequence    */ (PySequenceMethods *) 0,
+  /* tp_as_mapping     */ (PyMappingMethods *) 0,
+  /* tp_hash           */ (hashfunc) 0,
+  /* tp_call           */ (ternaryfunc) 0,
+  /* tp_str            */ (reprfunc) 0,
+  /* tp_getattro       */ (getattrofunc) 0,
+  /* tp_setattro       */ (setattrofunc) 0,
+  /* tp_as_buffer      */ (PyBufferProcs *) 0,
+  /* tp_flags          */ Py_TPFLAGS_DEFAULT,
+  /* tp_doc            */ (char *) 0,
+  /* tp_traverse       */ (traverseproc) 0,
+  /* tp_clear          */ (inquiry) 0,
+  /* tp_richcompare    */ (richcmpfunc) 0,
+  /* tp_weaklistoffset */ 0,
+  /* tp_iter           */ (getiterfunc) PyObject_SelfIter,
+  /* tp_iternext       */ (iternextfunc) record_iter_next,
+  /* tp_methods        */ (PyMethodDef *) 0,
+  /* tp_members        */ (PyMemberDef *) 0,
+  /* tp_getset         */ (PyGetSetDef *) 0,
+  /* tp_base           */ (PyTypeObject *) 0,
+  /* tp_dict           */ (PyObject *) 0,
+  /* tp_descr_get      */ (descrgetfunc) 0,
+  /* tp_descr_set      */ (descrsetfunc) 0,
+  /* tp_dictoffset     */ 0,
+  /* tp_init           */ (initproc) 0,
+  /* tp_alloc          */ (allocfunc) 0,
+  /* tp_new            */ (newfunc) 0,
+  /* tp_free           */ 0,
+};
+
+PyObject *Domlette_ParseRecords(PyObject *self, PyObject *args, PyObject *kw)
+{
+  static char *kwlist[] = {"source", "flags", "separator", "entity_factory",
+                           NULL};
+  PyObject *source, *separator=NULL, *entity_factory=NULL;
+  int flags=default_parse_flags;
+  RecordIterObject *iter;
+  ParserState *state;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kw, "O|iSO:parse_records", kwlist,
+                                   &source, &flags, &separator,
+                                   &entity_factory))
+    return NULL;
+
+  if (entity_factory == Py_None)
+    entity_factory = NULL;
+
+  state = ParserState_New(entity_factory);
+  if (state == NULL)
+    return NULL;
+  state->reader = create_reader(state);
+  if (state->reader == NULL) {
+    ParserState_Del(state);
+    return NULL;
+  }
+  Expat_SetValidation(state->reader, flags == PARSE_FLAGS_VALIDATE);
+  Expat_SetParamEntityParsing(state->reader, flags != PARSE_FLAGS_STANDALONE);
+
+  iter = PyObject_New(RecordIterObject, &RecordIter_Type);
+  if (iter == NULL) {
+    ExpatReader_Del(state->reader);
+    ParserState_Del(state);
+    return NULL;
+  }
+  iter->state = state;
+  Py_INCREF(source);
+  iter->source = source;
+  /* by default, only whitespace may appear between records */
+  if (separator == NULL)
+    separator = PyString_FromString("");
+  else
+    Py_INCREF(separator);
+  iter->separator = separator;
+  if (separator == NULL) {
+    Py_DECREF(iter);
+    return NULL;
+  }
+  return (PyObject *)iter;
+}
+
 /** Module Interface **************************************************/
 
 int DomletteBuilder_Init(PyObject *module)
@@ -933,6 +1112,7 @@ int DomletteBuilder_Init(PyObject *module)
 
   if (Expat_IMPORT == NULL) return -1;
   if (RuleMatch_Init() < 0) return -1;
+  if (PyType_Ready(&RecordIter_Type) < 0) return -1;
 
   empty_args_tuple = PyTuple_New(0);
   if (empty_args_tuple == NULL) return -1;
@@ -14,6 +14,9 @@ extern "C" {
   PyObject *Domlette_ParseFragment(PyObject *self, PyObject *args,
                                    PyObject *kw);
 
+  PyObject *Domlette_ParseRecords(PyObject *self, PyObject *args,
+                                  PyObject *kw);
+
   int DomletteBuilder_Init(PyObject *module);
   void DomletteBuilder_Fini(void);
 
@@ -15,9 +15,40 @@
 #define Container_SET_CHILD(op, i, v) (Container_GET_CHILD((op), (i)) = (v))
 //#define Container_GET_FROZEN(op)   (((ContainerObject *)(op))->frozen)
 #define Container_SET_FROZEN(op,v) (Container_GET_FROZEN(op) = (v))
+#define Container_GET_INLINE(op) (((ContainerObject *)(op))->inline_nodes)
+#define Container_IS_INLINE(op) \
+  (Container_GET_NODES(op) == Container_GET_INLINE(op))
 
 static PyObject *inserted_event;
 static PyObject *removed_event;
+static PyObject *spliced_event;
+
+/* Counts the changes made to children arrays (outside of the builder) and
+ * to element names, so that results computed from a tree, such as the
+ * element_index() of a document, can tell whether they are still valid. */
+unsigned long Container_MutationCount = 0;
+
+/* A container created outside of the builder starts out without a children
+ * array and owns whichever one it is given from then on.  Children arrays
+ * of up to Container_INLINE_SIZE nodes are stored in the container itself.
+ */
+Py_LOCAL_INLINE(void)
+container_init_nodes(ContainerObject *self)
+{
+  if (self->nodes == NULL) {
+    self->nodes = self->inline_nodes;
+    self->allocated = Container_INLINE_SIZE;
+    self->frozen = 1;
+  }
+}
+
+/* Releases the children array, if it is owned by the container */
+Py_LOCAL_INLINE(void)
+container_free_nodes(ContainerObject *self)
+{
+  if (self->frozen && self->nodes != self->inline_nodes)
+    PyMem_Free(self->nodes);
+}
 
 /* Ensure `nodes` has room for at least `newsize` elements, and set
  * `count` to `newsize`.  If `newsize` > `count` on entry, the content
@@ -36,7 +67,24 @@ Py_LOCAL_INLINE(int)
 container_resize(ContainerObject *self, Py_ssize_t newsize) {
   NodeObject **nodes;
   size_t new_allocated;
-  Py_ssize_t allocated = self->allocated;
+  Py_ssize_t allocated;
+
+  container_init_nodes(self);
+  allocated = self->allocated;
+
+  /* Small (frozen) arrays always live in the inline storage, moving back
+   * to it when they shrink. */
+  if (self->frozen && newsize <= Container_INLINE_SIZE) {
+    if (self->nodes != self->inline_nodes) {
+      memcpy(self->inline_nodes, self->nodes, sizeof(NodeObject *) *
+             (self->count < newsize ? self->count : newsize));
+      PyMem_Free(self->nodes);
+      self->nodes = self->inline_nodes;
+      self->allocated = Container_INLINE_SIZE;
+    }
+    self->count = newsize;
+    return 0;
+  }
 
   /* Bypass realloc() when a previous overallocation is large enough
      to accommodate the newsize.  If the newsize falls lower than half
@@ -62,10 +110,14 @@ container_resize(ContainerObject *self, Py_ssize_t newsize) {
   if (newsize == 0)
     new_allocated = 0;
   nodes = self->nodes;
-  if (new_allocated <= ((~(size_t)0) / sizeof(NodeObject *)))
-    PyMem_Resize(nodes, NodeObject *, new_allocated);
-  else
+  if (new_allocated > ((~(size_t)0) / sizeof(NodeObject *)))
     nodes = NULL;
+  else if (nodes == self->inline_nodes) {
+    nodes = PyMem_New(NodeObject *, new_allocated);
+    if (nodes != NULL)
+      memcpy(nodes, self->inline_nodes, sizeof(NodeObject *) * self->count);
+  } else
+    PyMem_Resize(nodes, NodeObject *, new_allocated);
   if (nodes == NULL) {
     PyErr_NoMemory();
     return -1;
@@ -150,6 +202,312 @@ container_index(NodeObject *self, NodeObject *child,
   return -1;
 }
 
+/* qsort()/bsearch() comparison for arrays of nodes sorted by address */
+static int compare_nodes(const void *a, const void *b)
+{
+  NodeObject *x = *((NodeObject **)a);
+  NodeObject *y = *((NodeObject **)b);
+  return (x < y) ? -1 : (x > y);
+}
+
+#define contains_node(sorted, size, node) \
+  (bsearch(&(node), (sorted), (size), sizeof(NodeObject *), compare_nodes) \
+   != NULL)
+
+Py_LOCAL_INLINE(int)
+try_dispatch_splice(NodeObject *self, PyObject *removed, PyObject *inserted)
+{
+  PyObject *result;
+  if (!Element_CheckExact(self) && !Entity_CheckExact(self)) {
+    result = PyObject_CallMethodObjArgs((PyObject *)self, spliced_event,
+                                        removed, inserted, NULL);
+    if (result == NULL)
+      return -1;
+    Py_DECREF(result);
+  }
+  return 0;
+}
+
+/* Removes from `self` all of its children found in `sorted` (an array of
+ * `size` nodes sorted by address) in a single pass.  The references held by
+ * the children array are given to `removed`, which must have been created
+ * with room for exactly those children.  Cannot fail; no event is sent. */
+Py_LOCAL(void)
+container_detach(NodeObject *self, NodeObject **sorted, Py_ssize_t size,
+                 PyObject *removed)
+{
+  NodeObject **nodes = Container_GET_NODES(self);
+  Py_ssize_t count = Container_GET_COUNT(self);
+  Py_ssize_t i, j, nremoved;
+
+  for (i = 0, j = 0, nremoved = 0; i < count; i++) {
+    NodeObject *node = nodes[i];
+    if (contains_node(sorted, size, node)) {
+      PyTuple_SET_ITEM(removed, nremoved++, (PyObject *)node);
+      Node_SET_PARENT(node, NULL);
+      Py_DECREF(self);
+    } else {
+      nodes[j++] = node;
+    }
+  }
+  assert(nremoved == PyTuple_GET_SIZE(removed));
+  /* shrinking cannot fail */
+  container_resize((ContainerObject *)self, j);
+  Container_MutationCount++;
+}
+
+/* Replaces the children in the slice [start:stop] of `self` with the `size`
+ * nodes in `newnodes` (the caller keeps its references to them).  Nodes
+ * that currently have a parent are first removed from it, including nodes
+ * that are already children of `self`.  Returns a tuple of the nodes that
+ * are no longer children of `self`, or NULL on error.  Everything that can
+ * fail is done before any of the nodes is moved, so an error leaves all
+ * the nodes where they were (except for errors raised by event handlers,
+ * which run once the splice is complete). */
+Py_LOCAL(PyObject *)
+container_splice(NodeObject *self, Py_ssize_t start, Py_ssize_t stop,
+                 NodeObject **newnodes, Py_ssize_t size)
+{
+  NodeObject **ancestors, **sorted, **parents, **nodes, **old, *node;
+  PyObject **detached, *removed = NULL, *inserted = NULL, *empty = NULL;
+  Py_ssize_t count, depth, nparents, ndetached, nremoved, newcount, i, j, k;
+  int have_self = 0;
+
+  if (self == NULL || !Container_Check(self) || size < 0 ||
+      (size > 0 && newnodes == NULL)) {
+    PyErr_BadInternalCall();
+    return NULL;
+  }
+
+  /* Validate everything up front; the ancestors of `self` are gathered once
+   * to check for circular insertions. */
+  for (node = self, depth = 0; node != NULL; node = Node_GET_PARENT(node))
+    depth++;
+  ancestors = PyMem_New(NodeObject *, depth);
+  sorted = PyMem_New(NodeObject *, size ? size : 1);
+  parents = PyMem_New(NodeObject *, size ? size : 1);
+  detached = PyMem_New(PyObject *, size ? size : 1);
+  if (ancestors == NULL || sorted == NULL || parents == NULL ||
+      detached == NULL) {
+    PyMem_Free(ancestors);
+    PyMem_Free(sorted);
+    PyMem_Free(parents);
+    PyMem_Free(detached);
+    return PyErr_NoMemory();
+  }
+  nparents = ndetached = 0;
+  for (node = self, depth = 0; node != NULL; node = Node_GET_PARENT(node))
+    ancestors[depth++] = node;
+  for (i = 0; i < size; i++) {
+    node = newnodes[i];
+    if (node == NULL) {
+      PyErr_BadInternalCall();
+      goto error;
+    }
+    if (!(Element_Check(node) || Text_Check(node) || Comment_Check(node) ||
+          ProcessingInstruction_Check(node))) {
+      PyErr_Format(PyExc_ValueError,
+                   "'%s' objects are not allowed as children",
+                   node->ob_type->tp_name);
+      goto error;
+    }
+    if (Element_Check(node)) {
+      for (j = 0; j < depth; j++) {
+        if (ancestors[j] == node) {
+          PyErr_Format(PyExc_ValueError, "child is already an ancestor");
+          goto error;
+        }
+      }
+    }
+    sorted[i] = node;
+  }
+  qsort(sorted, size, sizeof(NodeObject *), compare_nodes);
+  for (i = 1; i < size; i++) {
+    if (sorted[i] == sorted[i-1]) {
+      PyErr_Format(PyExc_ValueError, "duplicate child");
+      goto error;
+    }
+  }
+
+  /* Gather the other parents the nodes are taken from, along with a tuple
+   * for the nodes removed from each of them. */
+  for (i = 0; i < size; i++) {
+    NodeObject *parent = Node_GET_PARENT(newnodes[i]);
+    if (parent == self)
+      have_self = 1;
+    else if (parent != NULL)
+      parents[nparents++] = parent;
+  }
+  qsort(parents, nparents, sizeof(NodeObject *), compare_nodes);
+  for (i = 1, j = nparents ? 1 : 0; i < nparents; i++) {
+    if (parents[i] != parents[j-1])
+      parents[j++] = parents[i];
+  }
+  nparents = j;
+  /* a parent might otherwise go away along with its last child */
+  for (i = 0; i < nparents; i++)
+    Py_INCREF(parents[i]);
+  for (i = 0; i < nparents; i++) {
+    old = Container_GET_NODES(parents[i]);
+    count = Container_GET_COUNT(parents[i]);
+    for (j = 0, nremoved = 0; j < count; j++) {
+      if (contains_node(sorted, size, old[j]))
+        nremoved++;
+    }
+    detached[i] = PyTuple_New(nremoved);
+    if (detached[i] == NULL)
+      goto error;
+    ndetached++;
+  }
+  if (nparents) {
+    empty = PyTuple_New(0);
+    if (empty == NULL)
+      goto error;
+  }
+
+  container_init_nodes((ContainerObject *)self);
+  count = Container_GET_COUNT(self);
+  if (start < 0) {
+    start += count;
+    if (start < 0)
+      start = 0;
+  } else if (start > count)
+    start = count;
+  if (stop < 0) {
+    stop += count;
+    if (stop < 0)
+      stop = 0;
+  } else if (stop > count)
+    stop = count;
+  if (stop < start)
+    stop = start;
+
+  /* Count the children that go away for good and those that only move */
+  old = Container_GET_NODES(self);
+  newcount = count + size;
+  nremoved = stop - start;
+  if (have_self) {
+    for (i = 0; i < count; i++) {
+      if (contains_node(sorted, size, old[i])) {
+        newcount--;
+        if (i >= start && i < stop)
+          nremoved--;
+      }
+    }
+  }
+  newcount -= nremoved;
+
+  removed = PyTuple_New(nremoved);
+  if (removed == NULL)
+    goto error;
+  inserted = PyTuple_New(size);
+  if (inserted == NULL)
+    goto error;
+  nodes = PyMem_New(NodeObject *, newcount ? newcount : 1);
+  if (nodes == NULL) {
+    PyErr_NoMemory();
+    goto error;
+  }
+  if (!Container_GET_FROZEN(self) && newcount > Container_GET_ALLOCATED(self)) {
+    /* the builder's working array must grow in place */
+    if (container_resize((ContainerObject *)self, newcount) < 0) {
+      PyMem_Free(nodes);
+      goto error;
+    }
+    Container_SET_COUNT(self, count);
+    old = Container_GET_NODES(self);
+  }
+
+  /* Nothing can fail from here on; detach the nodes from the other
+   * parents, a parent at a time */
+  for (i = 0; i < nparents; i++)
+    container_detach(parents[i], sorted, size, detached[i]);
+
+  /* Assemble the new children array */
+  k = 0;
+  for (i = 0; i < start; i++) {
+    if (!(have_self && contains_node(sorted, size, old[i])))
+      nodes[k++] = old[i];
+  }
+  for (i = 0; i < size; i++) {
+    node = newnodes[i];
+    if (Node_GET_PARENT(node) == NULL) {
+      Py_INCREF(node);
+      Py_INCREF(self);
+      Node_SET_PARENT(node, self);
+    }
+    /* else, the reference held by the old array is reused */
+    nodes[k++] = node;
+    Py_INCREF(node);
+    PyTuple_SET_ITEM(inserted, i, (PyObject *)node);
+  }
+  for (i = start, j = 0; i < stop; i++) {
+    node = old[i];
+    if (!(have_self && contains_node(sorted, size, node))) {
+      /* the reference held by the old array is given to the tuple */
+      PyTuple_SET_ITEM(removed, j++, (PyObject *)node);
+      Node_SET_PARENT(node, NULL);
+      Py_DECREF(self);
+    }
+  }
+  for (i = stop; i < count; i++) {
+    if (!(have_self && contains_node(sorted, size, old[i])))
+      nodes[k++] = old[i];
+  }
+  assert(k == newcount);
+
+  if (Container_GET_FROZEN(self)) {
+    container_free_nodes((ContainerObject *)self);
+    if (newcount <= Container_INLINE_SIZE) {
+      memcpy(Container_GET_INLINE(self), nodes,
+             newcount * sizeof(NodeObject *));
+      PyMem_Free(nodes);
+      Container_SET_NODES(self, Container_GET_INLINE(self));
+      Container_SET_ALLOCATED(self, Container_INLINE_SIZE);
+    } else {
+      Container_SET_NODES(self, nodes);
+      Container_SET_ALLOCATED(self, newcount);
+    }
+  } else {
+    memcpy(old, nodes, newcount * sizeof(NodeObject *));
+    PyMem_Free(nodes);
+  }
+  Container_SET_COUNT(self, newcount);
+  Container_MutationCount++;
+  PyMem_Free(ancestors);
+  PyMem_Free(sorted);
+
+  /* Almost done; announce the changes with an event for each parent. */
+  for (i = 0; i < nparents; i++) {
+    if (removed != NULL &&
+        try_dispatch_splice(parents[i], detached[i], empty) < 0)
+      Py_CLEAR(removed);
+    Py_DECREF(detached[i]);
+    Py_DECREF(parents[i]);
+  }
+  PyMem_Free(parents);
+  PyMem_Free(detached);
+  Py_XDECREF(empty);
+  if (removed != NULL && try_dispatch_splice(self, removed, inserted) < 0)
+    Py_CLEAR(removed);
+  Py_DECREF(inserted);
+  return removed;
+
+error:
+  for (i = 0; i < ndetached; i++)
+    Py_DECREF(detached[i]);
+  for (i = 0; i < nparents; i++)
+    Py_DECREF(parents[i]);
+  Py_XDECREF(empty);
+  Py_XDECREF(removed);
+  Py_XDECREF(inserted);
+  PyMem_Free(ancestors);
+  PyMem_Free(sorted);
+  PyMem_Free(parents);
+  PyMem_Free(detached);
+  return NULL;
+}
+
 /** Public C API ******************************************************/
 
 
@@ -164,10 +522,7 @@ void _Container_Del(NodeObject *node)
 
     /* Only release the nodes array if frozen. Otherwise memory belongs
        to the builder. */
-
-    if (Container_GET_FROZEN(node)) {
-      PyMem_Free(nodes);
-    }
+    container_free_nodes((ContainerObject *)node);
   }
   _Node_Del(node);
 }
@@ -194,27 +549,34 @@ NodeObject ** _Container_GetWorkingChildren(NodeObject *self, Py_ssize_t *alloca
 
 /* Semi-private routine that freezes the set of children assigned to a
  * node.  This is done by making a copy of the working children set 
- * initialized by _Container_SetWorkingChildren above.
+ * initialized by _Container_SetWorkingChildren above.  The copy is sized
+ * exactly; small sets are copied into the node's inline storage.
  */
 int _Container_FreezeChildren(NodeObject *self) {
   NodeObject **nodes;
-  Py_ssize_t i, size;
+  Py_ssize_t i, size, allocated;
 
   assert(Container_GET_NODES(self) != NULL);
 
   size = Container_GET_COUNT(self);
 
   /* Create a copy of the working array */
-  nodes = PyMem_New(NodeObject *, size);
-  if (nodes == NULL) {
-    PyErr_NoMemory();
-    return -2;
+  if (size <= Container_INLINE_SIZE) {
+    nodes = Container_GET_INLINE(self);
+    allocated = Container_INLINE_SIZE;
+  } else {
+    nodes = PyMem_New(NodeObject *, size);
+    if (nodes == NULL) {
+      PyErr_NoMemory();
+      return -2;
+    }
+    allocated = size;
   }
   memcpy(nodes, Container_GET_NODES(self), sizeof(NodeObject *)*size);
 
   /* Save the new array */
   Container_SET_NODES(self, nodes);
-  Container_SET_ALLOCATED(self, size);
+  Container_SET_ALLOCATED(self, allocated);
   Container_SET_FROZEN(self,1);
 
   if (!Element_CheckExact(self) && !Entity_CheckExact(self)) {
@@ -347,6 +709,7 @@ int Container_Remove(NodeObject *self, NodeObject *child)
   /* Drop the reference to the removed node as it is no longer in the array */
   Py_DECREF(child);
 
+  Container_MutationCount++;
   return 0;
 }
 
@@ -379,6 +742,7 @@ int Container_Append(NodeObject *self, NodeObject *child)
   /* Set the parent relationship */
   Py_INCREF(self);
   Node_SET_PARENT(child, self);
+  Container_MutationCount++;
 
   /* Almost done; announce the addition of the child. */
   return try_dispatch_event(self, inserted_event, child);
@@ -433,6 +797,7 @@ int Container_Insert(NodeObject *self, Py_ssize_t where, NodeObject *child)
   /* Set the parent relationship */
   Py_INCREF(self);
   Node_SET_PARENT(child, self);
+  Container_MutationCount++;
 
   /* Almost done; announce the addition of the child. */
   return try_dispatch_event(self, inserted_event, child);
@@ -488,11 +853,22 @@ int Container_Replace(NodeObject *self, NodeObject *oldChild,
   /* Set the parent relationship */
   Py_INCREF(self);
   Node_SET_PARENT(newChild, self);
+  Container_MutationCount++;
 
   /* Almost done; announce the insertion of `newChild`. */
   return try_dispatch_event(self, inserted_event, newChild);
 }
 
+int Container_Splice(NodeObject *self, Py_ssize_t start, Py_ssize_t stop,
+                     NodeObject **nodes, Py_ssize_t size)
+{
+  PyObject *removed = container_splice(self, start, stop, nodes, size);
+  if (removed == NULL)
+    return -1;
+  Py_DECREF(removed);
+  return 0;
+}
+
 Py_ssize_t Container_Index(NodeObject *self, NodeObject *child)
 {
   if (!ensure_arguments(self, child))
@@ -500,6 +876,210 @@ Py_ssize_t Container_Index(NodeObject *self, NodeObject *child)
   return container_index(self, child, 0, Container_GET_COUNT(self));
 }
 
+/** Module Functions **************************************************/
+
+typedef struct {
+  Py_ssize_t containers;
+  Py_ssize_t children;
+  Py_ssize_t inline_arrays;
+  Py_ssize_t heap_arrays;
+  Py_ssize_t slots;
+} ChildrenProfile;
+
+Py_LOCAL(void)
+children_profile(NodeObject *node, ChildrenProfile *profile)
+{
+  Py_ssize_t i, count = Container_GET_COUNT(node);
+
+  profile->containers++;
+  profile->children += count;
+  profile->slots += Container_INLINE_SIZE;
+  if (Container_GET_NODES(node) == NULL || Container_IS_INLINE(node)) {
+    profile->inline_arrays++;
+  } else {
+    profile->heap_arrays++;
+    profile->slots += Container_GET_ALLOCATED(node);
+  }
+  for (i = 0; i < count; i++) {
+    NodeObject *child = Container_GET_CHILD(node, i);
+    if (Container_Check(child))
+      children_profile(child, profile);
+  }
+}
+
+PyObject *Domlette_ChildrenProfile(PyObject *self, PyObject *args)
+{
+  NodeObject *node;
+  ChildrenProfile profile;
+
+  if (!PyArg_ParseTuple(args, "O!:children_profile",
+                        &DomletteContainer_Type, &node))
+    return NULL;
+
+  memset(&profile, 0, sizeof(ChildrenProfile));
+  children_profile(node, &profile);
+  return Py_BuildValue("{snsnsnsnsnsn}",
+                       "containers", profile.containers,
+                       "children", profile.children,
+                       "inline_arrays", profile.inline_arrays,
+                       "heap_arrays", profile.heap_arrays,
+                       "allocated_bytes",
+                       (Py_ssize_t)(profile.slots * sizeof(NodeObject *)),
+                       "wasted_bytes",
+                       (Py_ssize_t)((profile.slots - profile.children) *
+                                    sizeof(NodeObject *)));
+}
+
+/* Returns true if `name` equals the name in `*key`, where a NULL key
+ * matches any name.  The names of a parsed tree are mostly shared strings,
+ * so once a key is found equal to a name of the tree, that name becomes
+ * the key and further matches are decided by identity. */
+Py_LOCAL_INLINE(int)
+name_matches(PyObject **key, PyObject *name)
+{
+  PyObject *k = *key;
+  if (k == NULL || k == name)
+    return 1;
+  if (k == Py_None || name == Py_None ||
+      PyUnicode_GET_SIZE(k) != PyUnicode_GET_SIZE(name) ||
+      memcmp(PyUnicode_AS_UNICODE(k), PyUnicode_AS_UNICODE(name),
+             PyUnicode_GET_SIZE(k) * sizeof(Py_UNICODE)) != 0)
+    return 0;
+  *key = name;
+  return 1;
+}
+
+Py_LOCAL(int)
+elements_by_name(NodeObject *node, PyObject **namespace, PyObject **local,
+                 PyObject *result)
+{
+  Py_ssize_t i, count = Container_GET_COUNT(node);
+
+  for (i = 0; i < count; i++) {
+    NodeObject *child = Container_GET_CHILD(node, i);
+    if (!Element_Check(child))
+      continue;
+    if (name_matches(local, Element_LOCAL_NAME(child)) &&
+        name_matches(namespace, Element_NAMESPACE_URI(child)) &&
+        PyList_Append(result, (PyObject *)child) < 0)
+      return -1;
+    if (Container_GET_COUNT(child)) {
+      int rc;
+      if (Py_EnterRecursiveCall(" in elements_by_name"))
+        return -1;
+      rc = elements_by_name(child, namespace, local, result);
+      Py_LeaveRecursiveCall();
+      if (rc < 0)
+        return -1;
+    }
+  }
+  return 0;
+}
+
+/* Converts a name argument of elements_by_name() to its key; the wildcard
+ * '*' is returned as Py_None with `*key` set to NULL. */
+Py_LOCAL(PyObject *)
+name_key(PyObject *arg, char *name, int nullable, PyObject **key)
+{
+  PyObject *value = XmlString_ConvertArgument(arg, name, nullable);
+  if (value == NULL)
+    return NULL;
+  if (value != Py_None && PyUnicode_GET_SIZE(value) == 1 &&
+      PyUnicode_AS_UNICODE(value)[0] == '*')
+    *key = NULL;
+  else
+    *key = value;
+  return value;
+}
+
+PyObject *Domlette_ElementsByName(PyObject *self, PyObject *args)
+{
+  NodeObject *node;
+  PyObject *namespace, *local, *namespace_key, *local_key, *result = NULL;
+
+  if (!PyArg_ParseTuple(args, "O!OO:elements_by_name",
+                        &DomletteContainer_Type, &node, &namespace, &local))
+    return NULL;
+
+  namespace = name_key(namespace, "namespace", 1, &namespace_key);
+  if (namespace == NULL)
+    return NULL;
+  local = name_key(local, "local", 0, &local_key);
+  if (local == NULL)
+    goto finally;
+  result = PyList_New(0);
+  if (result != NULL &&
+      elements_by_name(node, &namespace_key, &local_key, result) < 0)
+    Py_CLEAR(result);
+
+finally:
+  Py_DECREF(namespace);
+  Py_XDECREF(local);
+  return result;
+}
+
+Py_LOCAL(int)
+element_index(NodeObject *node, PyObject *index)
+{
+  Py_ssize_t i, count = Container_GET_COUNT(node);
+
+  for (i = 0; i < count; i++) {
+    NodeObject *child = Container_GET_CHILD(node, i);
+    PyObject *key, *elements;
+    int rc;
+    if (!Element_Check(child))
+      continue;
+    key = PyTuple_Pack(2, Element_NAMESPACE_URI(child),
+                       Element_LOCAL_NAME(child));
+    if (key == NULL)
+      return -1;
+    elements = PyDict_GetItem(index, key);
+    if (elements == NULL) {
+      elements = PyList_New(0);
+      if (elements == NULL || PyDict_SetItem(index, key, elements) < 0) {
+        Py_XDECREF(elements);
+        Py_DECREF(key);
+        return -1;
+      }
+      Py_DECREF(elements);
+    }
+    Py_DECREF(key);
+    if (PyList_Append(elements, (PyObject *)child) < 0)
+      return -1;
+    if (Container_GET_COUNT(child)) {
+      if (Py_EnterRecursiveCall(" in element_index"))
+        return -1;
+      rc = element_index(child, index);
+      Py_LeaveRecursiveCall();
+      if (rc < 0)
+        return -1;
+    }
+  }
+  return 0;
+}
+
+PyObject *Domlette_MutationCount(PyObject *self, PyObject *args)
+{
+  if (!PyArg_ParseTuple(args, ":mutation_count"))
+    return NULL;
+  return PyLong_FromUnsignedLong(Container_MutationCount);
+}
+
+PyObject *Domlette_ElementIndex(PyObject *self, PyObject *args)
+{
+  NodeObject *node;
+  PyObject *index;
+
+  if (!PyArg_ParseTuple(args, "O!:element_index",
+                        &DomletteContainer_Type, &node))
+    return NULL;
+
+  index = PyDict_New();
+  if (index != NULL && element_index(node, index) < 0)
+    Py_CLEAR(index);
+  return index;
+}
+
 /** Python Methods ****************************************************/
 
 static char xml_normalize_doc[] = "\
@@ -616,6 +1196,44 @@ static PyObject *xml_insert(NodeObject *self, PyObject *args)
   return (PyObject *)child;
 }
 
+static char xml_splice_doc[] = "xml_splice(start, stop, nodes) -> tuple\n\n\
+Replaces the children from position `start` up to (but not including)\n\
+`stop` with the nodes in the sequence `nodes`, as for slice assignment.\n\
+Returns a tuple of the nodes removed from the children. A single\n\
+xml_children_spliced event is dispatched for the whole change.";
+
+static PyObject *xml_splice(NodeObject *self, PyObject *args)
+{
+  Py_ssize_t start, stop, size, i;
+  PyObject *sequence, *result;
+  PyObject **items;
+
+  start = 0;
+  stop = PY_SSIZE_T_MAX;
+  if (!PyArg_ParseTuple(args, "O&O&O:xml_splice",
+                        _PyEval_SliceIndex, &start,
+                        _PyEval_SliceIndex, &stop,
+                        &sequence))
+    return NULL;
+
+  sequence = PySequence_Fast(sequence, "nodes must be a sequence");
+  if (sequence == NULL)
+    return NULL;
+  size = PySequence_Fast_GET_SIZE(sequence);
+  items = PySequence_Fast_ITEMS(sequence);
+  for (i = 0; i < size; i++) {
+    if (!Node_Check(items[i])) {
+      PyErr_Format(PyExc_TypeError, "nodes must contain only nodes, not %s",
+                   items[i]->ob_type->tp_name);
+      Py_DECREF(sequence);
+      return NULL;
+    }
+  }
+  result = container_splice(self, start, stop, (NodeObject **)items, size);
+  Py_DECREF(sequence);
+  return result;
+}
+
 static char xml_replace_doc[] = "xml_replace(old, new) -> old\n\n\
 Replaces the node `old` with the node `new` in the children.";
 
@@ -675,6 +1293,35 @@ static PyObject *xml_child_removed(PyObject *self, PyObject *child)
   Py_RETURN_NONE;
 }
 
+static char xml_children_spliced_doc[] = \
+"xml_children_spliced(removed, inserted)\n\n\
+Several children have been removed and/or inserted at once by xml_splice().\n\
+This event is dispatched after the change has taken place. `removed` and\n\
+`inserted` are tuples of the affected nodes. By default, xml_child_removed\n\
+and xml_child_inserted are dispatched for each of them in turn.";
+
+static PyObject *xml_children_spliced(PyObject *self, PyObject *args)
+{
+  PyObject *removed, *inserted;
+  Py_ssize_t i;
+
+  if (!PyArg_ParseTuple(args, "O!O!:xml_children_spliced",
+                        &PyTuple_Type, &removed, &PyTuple_Type, &inserted))
+    return NULL;
+
+  for (i = 0; i < PyTuple_GET_SIZE(removed); i++) {
+    if (Node_DispatchEvent((NodeObject *)self, removed_event,
+                           (NodeObject *)PyTuple_GET_ITEM(removed, i)) < 0)
+      return NULL;
+  }
+  for (i = 0; i < PyTuple_GET_SIZE(inserted); i++) {
+    if (Node_DispatchEvent((NodeObject *)self, inserted_event,
+                           (NodeObject *)PyTuple_GET_ITEM(inserted, i)) < 0)
+      return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
 #define PyMethod_INIT(NAME, FLAGS) \
   { #NAME, (PyCFunction)NAME, FLAGS, NAME##_doc }
 
@@ -684,10 +1331,12 @@ static PyMethodDef container_methods[] = {
   PyMethod_INIT(xml_append,    METH_VARARGS),
   PyMethod_INIT(xml_insert,    METH_VARARGS),
   PyMethod_INIT(xml_replace,   METH_VARARGS),
+  PyMethod_INIT(xml_splice,    METH_VARARGS),
   PyMethod_INIT(xml_index,     METH_VARARGS),
   /* mutation events */
   PyMethod_INIT(xml_child_inserted, METH_O),
   PyMethod_INIT(xml_child_removed,  METH_O),
+  PyMethod_INIT(xml_children_spliced, METH_VARARGS),
   { NULL }
 };
 
@@ -771,9 +1420,9 @@ static int container_clear(PyObject *self)
       Py_CLEAR(nodes[i]);
     }
     if (Container_GET_FROZEN(self)) {
+      container_free_nodes((ContainerObject *)self);
       Container_SET_NODES(self,NULL);
       Container_SET_ALLOCATED(self,0);
-      PyMem_Free(nodes);
     }
   }
   return DomletteNode_Type.tp_clear(self);
@@ -936,6 +1585,9 @@ int DomletteContainer_Init(PyObject *module)
   removed_event = PyString_FromString("xml_child_removed");
   if (removed_event == NULL)
     return -1;
+  spliced_event = PyString_FromString("xml_children_spliced");
+  if (spliced_event == NULL)
+    return -1;
 
   return 0;
 }
@@ -944,6 +1596,7 @@ void DomletteContainer_Fini(void)
 {
   Py_DECREF(inserted_event);
   Py_DECREF(removed_event);
+  Py_DECREF(spliced_event);
   PyType_CLEAR(&DomletteContainer_Type);
   PyType_CLEAR(&NodeIter_Type);
 }
@@ -8,13 +8,18 @@ extern "C" {
 #include "Python.h"
 #include "node.h"
 
+  /* Number of children stored directly in the container object instead of
+   * a separately allocated array. */
+#define Container_INLINE_SIZE 2
+
   /* Container_HEAD defines the initial segment of all container nodes. */
 #define Container_HEAD      \
     Node_HEAD               \
     Py_ssize_t count;       \
     NodeObject **nodes;     \
     Py_ssize_t allocated;   \
-    int        frozen;
+    int        frozen;      \
+    NodeObject *inline_nodes[Container_INLINE_SIZE];
 
   /* Nothing is actually declared to be a ContainerObject, but every pointer 
    * to a Domlette container object can be cast to a ContainerObject*.
@@ -58,8 +63,17 @@ extern "C" {
   int Container_Remove(NodeObject *self, NodeObject *child);
   int Container_Insert(NodeObject *self, Py_ssize_t where, NodeObject *child);
   int Container_Replace(NodeObject *self, NodeObject *old, NodeObject *new);
+  int Container_Splice(NodeObject *self, Py_ssize_t start, Py_ssize_t stop,
+                       NodeObject **nodes, Py_ssize_t size);
   Py_ssize_t Container_Index(NodeObject *self, NodeObject *child);
 
+  PyObject *Domlette_ChildrenProfile(PyObject *self, PyObject *args);
+  PyObject *Domlette_ElementsByName(PyObject *self, PyObject *args);
+  PyObject *Domlette_ElementIndex(PyObject *self, PyObject *args);
+  PyObject *Domlette_MutationCount(PyObject *self, PyObject *args);
+
+  extern unsigned long Container_MutationCount;
+
 #endif /* Domlette_BUILDING_MODULE */
 
 #ifdef __cplusplus
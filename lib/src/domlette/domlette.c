@@ -15,6 +15,7 @@ Project home, documentation, distributions: http://4suite.org/\n\
 #include "xmlstring.h"
 #include "domlette_interface.h"
 #include "builder.h"
+#include "binary.h"
 #include "refcounts.h"
 
 /*
@@ -475,6 +476,36 @@ static PyMethodDef module_methods[] = {
     "parse(source[, flags[, node_factories]]) -> Document" },
   { "parse_fragment", (PyCFunction) Domlette_ParseFragment, METH_KEYWORDS,
     "parse_fragment(source[, namespaces[, node_factories]]) -> Document" },
+  { "parse_records", (PyCFunction) Domlette_ParseRecords, METH_KEYWORDS,
+    "parse_records(source[, flags[, separator[, entity_factory]]])\n"
+    "  -> iterator of Documents" },
+
+  /* from container.c */
+  { "children_profile", Domlette_ChildrenProfile, METH_VARARGS,
+    "children_profile(node) -> dict\n\nReports how the children arrays of "
+    "`node` and its descendants\nuse memory: the number of containers and "
+    "children, how many arrays\nare stored inline or separately allocated, "
+    "and the bytes allocated\nfor, and wasted by unused, child slots." },
+  { "elements_by_name", Domlette_ElementsByName, METH_VARARGS,
+    "elements_by_name(node, namespace, local) -> list\n\nReturns the "
+    "descendant elements of `node` with the given namespace\nand local "
+    "name, in document order.  Either name may be the wildcard '*'." },
+  { "element_index", Domlette_ElementIndex, METH_VARARGS,
+    "element_index(node) -> dict\n\nMaps each (namespace, local) name of "
+    "the descendant elements of `node`\nto the list of those elements, in "
+    "document order." },
+  { "mutation_count", Domlette_MutationCount, METH_VARARGS,
+    "mutation_count() -> int\n\nReturns a number that changes whenever "
+    "children are added to or removed\nfrom a node, or an element is "
+    "renamed." },
+
+  /* from binary.c */
+  { "dumps", Domlette_Dumps, METH_VARARGS,
+    "dumps(node) -> string\n\nReturns a binary image of the entity or element "
+    "`node` and its descendants." },
+  { "loads", Domlette_Loads, METH_VARARGS,
+    "loads(buffer) -> node\n\nRebuilds a tree from a binary image created by "
+    "dumps().\n`buffer` can be a string, mmap or any other read buffer." },
 
   /* from nss.c */
   //Domlette_METHOD(GetAllNs, METH_VARARGS),
@@ -520,6 +551,8 @@ static Domlette_APIObject Domlette_API = {
   NamespaceMap_Next,
 
   AttributeMap_Next,
+
+  Container_Splice,
 };
 
 struct submodule_t {
@@ -531,6 +564,7 @@ struct submodule_t {
 struct submodule_t submodules[] = {
   SUBMODULE(Exceptions),
   SUBMODULE(Builder),
+  SUBMODULE(Binary),
   SUBMODULE(Node),
   SUBMODULE(Container),
   SUBMODULE(NamespaceMap),
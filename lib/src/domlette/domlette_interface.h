@@ -85,6 +85,10 @@ extern "C" {
     /* AttributeMap Methods */
     AttrObject *(*AttributeMap_Next)(PyObject *nodemap, Py_ssize_t *ppos);
 
+    int (*Container_Splice)(NodeObject *parent, Py_ssize_t start,
+                            Py_ssize_t stop, NodeObject **nodes,
+                            Py_ssize_t size);
+
   } Domlette_APIObject;
 
 #ifdef Domlette_BUILDING_MODULE
@@ -123,6 +127,7 @@ extern "C" {
 #define Container_Append Domlette->Container_Append
 #define Container_Insert Domlette->Container_Insert
 #define Container_Replace Domlette->Container_Replace
+#define Container_Splice Domlette->Container_Splice
 
 #define Entity_Check(op) PyObject_TypeCheck((op), DomletteEntity_Type)
 #define Entity_CheckExact(op) ((op)->ob_type == DomletteEntity_Type)
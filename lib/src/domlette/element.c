@@ -765,6 +765,7 @@ finally:
   Element_LOCAL_NAME(self) = local;
   Py_DECREF(Element_QNAME(self));
   Element_QNAME(self) = qname;
+  Container_MutationCount++;
   return 0;
 }
 
@@ -802,6 +803,7 @@ static int set_namespace(PyObject *self, PyObject *v, void *arg)
   Element_NAMESPACE_URI(self) = namespace;
   Py_DECREF(Element_QNAME(self));
   Element_QNAME(self) = qname;
+  Container_MutationCount++;
   return 0;
 }
 
@@ -93,6 +93,9 @@ Expat wrapper library";
 #define EXPAT_BUFSIZ   65536
 /* 8K buffer should be plenty for most documents (it does resize if needed) */
 #define XMLCHAR_BUFSIZ 8192
+/* input following a record is copied out before the parser is reset, so
+ * record parsing reads in smaller chunks to keep those copies cheap */
+#define RECORD_BUFSIZ  8192
 
 static PyObject *read_string;
 static PyObject *empty_string;
@@ -218,8 +221,22 @@ typedef struct {
   PyObject *preserve_flag;
 } WhitespaceRule;
 
+/* The rules are compiled into an open-addressed table keyed by the
+ * (interned) namespace and local name pointers.  Namespace tests are stored
+ * with a NULL local name and the (single) element test is kept separately.
+ * Each entry remembers the position of the rule it came from so that the
+ * first matching rule still wins. */
+typedef struct {
+  PyObject *test_namespace;     /* NULL marks an unused slot */
+  PyObject *test_name;
+  Py_ssize_t index;
+} WhitespaceRuleEntry;
+
 typedef struct {
   Py_ssize_t size;
+  Py_ssize_t mask;              /* the table contains mask + 1 slots */
+  WhitespaceRuleEntry *table;
+  Py_ssize_t element_test;      /* index of the first `*` rule, or -1 */
   WhitespaceRule items[1];
 } WhitespaceRules;
 
@@ -249,6 +266,14 @@ struct ExpatReaderStruct {
 
   WhitespaceRules *whitespace_rules;  /* array of stripping rules */
   Stack *preserve_whitespace_stack;   /* whitespace stripping allowed */
+
+  /* record parsing (see ExpatReader_ParseRecords) */
+  PyObject *record_separator;   /* PyStringObject of delimiting bytes */
+  char *record_buffer;          /* input following the last record */
+  size_t record_allocated;      /* size of record_buffer */
+  size_t record_start;          /* unconsumed input in record_buffer */
+  size_t record_end;
+  Py_ssize_t record_depth;      /* element depth within the record */
 };
 
 #define ExpatReader_HasFlag(p,f) ((((ExpatReader *)(p))->flags & (f)) == (f))
@@ -262,6 +287,7 @@ struct ExpatReaderStruct {
 #define ExpatReader_ENTITY_RESOLVER      (1L<<3)
 #define ExpatReader_ERROR_HANDLERS       (1L<<4)
 #define ExpatReader_DTD_DECLARATIONS     (1L<<5)
+#define ExpatReader_RECORDS              (1L<<6)
 
 /** DTD ***************************************************************/
 
@@ -1039,12 +1065,34 @@ intern_string(ExpatReader *reader, PyObject *obj)
 
 /** Whitespace Stripping **********************************************/
 
+#define WhitespaceRules_HASH(ns, name) \
+  ((((size_t)(ns)) >> 3) * 1000003 ^ (((size_t)(name)) >> 3))
+
+Py_LOCAL_INLINE(WhitespaceRuleEntry *)
+whitespace_rules_lookup(WhitespaceRules *rules, PyObject *namespaceURI,
+                        PyObject *localName)
+{
+  register size_t i = WhitespaceRules_HASH(namespaceURI, localName);
+  register WhitespaceRuleEntry *entry;
+
+  /* NOTE: We can use exact pointer compares as the names are interned */
+  while (1) {
+    entry = &rules->table[i & rules->mask];
+    if (entry->test_namespace == NULL ||
+        (entry->test_namespace == namespaceURI &&
+         entry->test_name == localName))
+      return entry;
+    i++;
+  }
+}
+
 Py_LOCAL_INLINE(WhitespaceRules *)
 create_whitespace_rules(ExpatReader *reader, PyObject *sequence)
 {
-  Py_ssize_t i, length;
+  Py_ssize_t i, length, slots;
   size_t nbytes;
   WhitespaceRules *rules;
+  WhitespaceRuleEntry *entry;
 
   if (sequence == NULL) {
     PyErr_BadInternalCall();
@@ -1056,7 +1104,8 @@ create_whitespace_rules(ExpatReader *reader, PyObject *sequence)
     return NULL;
   length = PyTuple_GET_SIZE(sequence);
   assert(length >= 0);
-  nbytes = SIZEOF_INT + (sizeof(WhitespaceRule) * (size_t)length);
+  nbytes = offsetof(WhitespaceRules, items) +
+    (sizeof(WhitespaceRule) * (size_t)(length ? length : 1));
   rules = (WhitespaceRules *)PyObject_MALLOC(nbytes);
   if (rules == NULL) {
     Py_DECREF(sequence);
@@ -1065,6 +1114,19 @@ create_whitespace_rules(ExpatReader *reader, PyObject *sequence)
   }
   memset(rules, '\0', nbytes);
   rules->size = length;
+  rules->element_test = -1;
+
+  /* keep the table at most half full */
+  for (slots = 8; slots <= length * 2; slots <<= 1);
+  rules->mask = slots - 1;
+  rules->table = PyMem_New(WhitespaceRuleEntry, slots);
+  if (rules->table == NULL) {
+    PyObject_FREE(rules);
+    Py_DECREF(sequence);
+    PyErr_NoMemory();
+    return NULL;
+  }
+  memset(rules->table, '\0', sizeof(WhitespaceRuleEntry) * slots);
 
   for (i = 0; i < length; i++) {
     PyObject *namespace_uri, *local_name, *flag;
@@ -1083,34 +1145,44 @@ create_whitespace_rules(ExpatReader *reader, PyObject *sequence)
        on level of specificity.  This code assumes the list of white space
        rules has already been sorted by precedence.
     */
+    if (namespace_uri != Py_None) {
+      namespace_uri = intern_string(reader, namespace_uri);
+      if (namespace_uri == NULL)
+        goto error;
+    }
     switch (PyObject_RichCompareBool(local_name, asterisk_string, Py_EQ)) {
     case 1:
       if (namespace_uri == Py_None) {
         /* rule matches every element */
         rules->items[i].test_type = ELEMENT_TEST;
+        if (rules->element_test < 0)
+          rules->element_test = i;
+        entry = NULL;
       } else {
         /* rule matches any element in the target namespace */
-        namespace_uri = intern_string(reader, namespace_uri);
-        if (namespace_uri == NULL)
-          goto error;
         rules->items[i].test_type = NAMESPACE_TEST;
         rules->items[i].test_namespace = namespace_uri;
+        entry = whitespace_rules_lookup(rules, namespace_uri, NULL);
       }
       break;
     case 0:
-      namespace_uri = intern_string(reader, namespace_uri);
-      if (namespace_uri == NULL)
-        goto error;
       local_name = intern_string(reader, local_name);
       if (local_name == NULL)
         goto error;
       rules->items[i].test_type = EXPANDED_NAME_TEST;
       rules->items[i].test_namespace = namespace_uri;
       rules->items[i].test_name = local_name;
+      entry = whitespace_rules_lookup(rules, namespace_uri, local_name);
       break;
     default:
       goto error;
     }
+    /* only the first of any duplicate rules can ever match */
+    if (entry != NULL && entry->test_namespace == NULL) {
+      entry->test_namespace = rules->items[i].test_namespace;
+      entry->test_name = rules->items[i].test_name;
+      entry->index = i;
+    }
     switch (PyObject_IsTrue(flag)) {
     case 1:
       rules->items[i].preserve_flag = Py_False;
@@ -1126,6 +1198,7 @@ create_whitespace_rules(ExpatReader *reader, PyObject *sequence)
   return rules;
 
 error:
+  PyMem_Del(rules->table);
   PyObject_FREE(rules);
   Py_DECREF(sequence);
   return NULL;
@@ -1135,6 +1208,7 @@ Py_LOCAL_INLINE(void)
 destroy_whitespace_rules(WhitespaceRules *rules)
 {
   /* all test values are borrowed references from the unicode intern table */
+  PyMem_Del(rules->table);
   PyObject_FREE(rules);
 }
 
@@ -1143,25 +1217,22 @@ is_whitespace_preserving(ExpatReader *reader, PyObject *namespaceURI,
                          PyObject *localName)
 {
   WhitespaceRules *rules = reader->whitespace_rules;
-  register WhitespaceRule *rule;
-  register size_t size;
+  WhitespaceRuleEntry *entry;
+  Py_ssize_t index;
 
-  /* NOTE: We can use exact pointer compares as the names are interned */
   if (rules != NULL) {
-    for (size = rules->size, rule = rules->items; size > 0; size--, rule++) {
-      switch (rule->test_type) {
-      case EXPANDED_NAME_TEST:
-        if (rule->test_name != localName)
-          break;
-        /* else, fall through for namespace-uri test */
-      case NAMESPACE_TEST:
-        if (rule->test_namespace != namespaceURI)
-          break;
-        /* else, fall through to handle match */
-      case ELEMENT_TEST:
-        return rule->preserve_flag;
-      }
-    }
+    /* the first matching rule (in document order) wins */
+    index = rules->element_test;
+    if (index != 0) {
+      entry = whitespace_rules_lookup(rules, namespaceURI, localName);
+      if (entry->test_namespace && (index < 0 || entry->index < index))
+        index = entry->index;
+      entry = whitespace_rules_lookup(rules, namespaceURI, NULL);
+      if (entry->test_namespace && (index < 0 || entry->index < index))
+        index = entry->index;
+    }
+    if (index >= 0)
+      return rules->items[index].preserve_flag;
   }
   /* by default, all elements are whitespace-preserving */
   return Py_True;
@@ -1376,18 +1447,12 @@ static XML_Char expat_default_string[] = {
 static int expat_UnknownEncoding(void *arg, const XML_Char *name,
                                  XML_Encoding *info);
 
-Py_LOCAL_INLINE(XML_Parser)
-create_parser(ExpatReader *reader)
+/* Apply the reader's settings to a newly created (or reset) parser */
+Py_LOCAL_INLINE(void)
+init_parser(ExpatReader *reader, XML_Parser parser)
 {
-  static const XML_Char sep[] = { NAMESPACE_SEP, '\0' };
   enum XML_ParamEntityParsing parsing;
 
-  XML_Parser parser = XML_ParserCreate_MM(NULL, &expat_memsuite, sep);
-  if (parser == NULL) {
-    PyErr_NoMemory();
-    return NULL;
-  }
-
   /* enable parsing of parameter entities if requested */
   if (ExpatReader_HasFlag(reader, ExpatReader_DTD_VALIDATION))
     parsing = ExpatReader_PARAM_ENTITY_PARSING;
@@ -1404,6 +1469,19 @@ create_parser(ExpatReader *reader)
   XML_SetUnknownEncodingHandler(parser, expat_UnknownEncoding, (void *)reader);
 
   XML_SetUserData(parser, (void *)reader);
+}
+
+Py_LOCAL_INLINE(XML_Parser)
+create_parser(ExpatReader *reader)
+{
+  static const XML_Char sep[] = { NAMESPACE_SEP, '\0' };
+
+  XML_Parser parser = XML_ParserCreate_MM(NULL, &expat_memsuite, sep);
+  if (parser == NULL) {
+    PyErr_NoMemory();
+    return NULL;
+  }
+  init_parser(reader, parser);
 
   return parser;
 }
@@ -1463,6 +1541,25 @@ static Py_ssize_t read_object(PyObject *stream, char *buffer, int length)
   return bytes_read;
 }
 
+Py_LOCAL_INLINE(void)
+get_read_func(ExpatReader *reader,
+              Py_ssize_t (**read_func)(PyObject *, char *, int),
+              PyObject **read_arg)
+{
+  PyObject *stream = reader->context->stream;
+  if (PyFile_Check(stream)) {
+    *read_func = read_file;
+    *read_arg = (PyObject *) PyFile_AsFile(stream);
+  }
+  else if (PycStringIO_InputCheck(stream)) {
+    *read_func = read_stringio;
+    *read_arg = stream;
+  } else {
+    *read_func = read_object;
+    *read_arg = stream;
+  }
+}
+
 /* Common handling of Expat error condition. */
 Py_LOCAL_INLINE(void)
 process_error(ExpatReader *reader)
@@ -1534,30 +1631,26 @@ continue_parsing(ExpatReader *reader)
   PyObject *read_arg;
   enum XML_Status status;
   Py_ssize_t bytes_read;
+  int bufsize;
 
   Debug_ParserFunctionCall(continue_parsing, reader);
 
-  read_arg = reader->context->stream;
-  if (PyFile_Check(read_arg)) {
-    read_func = read_file;
-    read_arg = (PyObject *) PyFile_AsFile(read_arg);
-  }
-  else if (PycStringIO_InputCheck(read_arg)) {
-    read_func = read_stringio;
-  } else {
-    read_func = read_object;
-  }
+  get_read_func(reader, &read_func, &read_arg);
+  if (ExpatReader_HasFlag(reader, ExpatReader_RECORDS))
+    bufsize = RECORD_BUFSIZ;
+  else
+    bufsize = EXPAT_BUFSIZ;
 
   do {
     XML_ParsingStatus parsing_status;
-    void *buffer = XML_GetBuffer(reader->context->parser, EXPAT_BUFSIZ);
+    void *buffer = XML_GetBuffer(reader->context->parser, bufsize);
     if (buffer == NULL) {
       process_error(reader);
       Debug_ReturnStatus(continue_parsing, EXPAT_STATUS_ERROR);
       return EXPAT_STATUS_ERROR;
     }
 
-    bytes_read = read_func(read_arg, (char *)buffer, EXPAT_BUFSIZ);
+    bytes_read = read_func(read_arg, (char *)buffer, bufsize);
     if (bytes_read < 0) {
       Debug_ReturnStatus(continue_parsing, EXPAT_STATUS_ERROR);
       return EXPAT_STATUS_ERROR;
@@ -1593,15 +1686,12 @@ continue_parsing(ExpatReader *reader)
   return EXPAT_STATUS_OK;
 }
 
-/* The entry point for parsing any entity, document or otherwise. */
+/* Set the encoding and base URI of the current context on its parser */
 Py_LOCAL_INLINE(ExpatStatus)
-do_parsing(ExpatReader *reader)
+prepare_parsing(ExpatReader *reader)
 {
   XML_Char *encoding, *base;
   enum XML_Status xml_status;
-  ExpatStatus status;
-
-  Debug_ParserFunctionCall(do_parsing, reader);
 
   /* sanity check */
   if (reader->context == NULL) {
@@ -1634,8 +1724,20 @@ do_parsing(ExpatReader *reader)
     PyErr_NoMemory();
     return EXPAT_STATUS_ERROR;
   }
+  return EXPAT_STATUS_OK;
+}
 
-  status = continue_parsing(reader);
+/* The entry point for parsing any entity, document or otherwise. */
+Py_LOCAL_INLINE(ExpatStatus)
+do_parsing(ExpatReader *reader)
+{
+  ExpatStatus status;
+
+  Debug_ParserFunctionCall(do_parsing, reader);
+
+  status = prepare_parsing(reader);
+  if (status == EXPAT_STATUS_OK)
+    status = continue_parsing(reader);
 
   Debug_ReturnStatus(do_parsing, status);
   return status;
@@ -2010,6 +2112,10 @@ static void expat_StartElement(ExpatReader *reader, const XML_Char *expat_name,
   Debug_PrintArray(expat_atts, Debug_PrintXMLChar);
   Debug_Print(")\n");
 
+  if (ExpatReader_HasFlag(reader, ExpatReader_RECORDS) &&
+      reader->context->next == NULL)
+    reader->record_depth++;
+
   if (charbuf_reset(reader) == EXPAT_STATUS_ERROR)
     return;
 
@@ -2227,6 +2333,42 @@ static void expat_StartElement(ExpatReader *reader, const XML_Char *expat_name,
 
 /** Expat EndElement Handler ******************************************/
 
+/* Called when the document element of a record has ended.  The input
+ * following it is saved for the next record (it is lost when the parser
+ * is reset) and parsing is suspended.
+ */
+Py_LOCAL_INLINE(ExpatStatus)
+end_record(ExpatReader *reader)
+{
+  XML_Parser parser = reader->context->parser;
+  const char *input;
+  int offset, size;
+  size_t length;
+
+  input = XML_GetInputContext(parser, &offset, &size);
+  if (input == NULL) {
+    PyErr_SetString(PyExc_SystemError, "record input not available");
+    return EXPAT_STATUS_ERROR;
+  }
+  /* skip over the end tag itself */
+  offset += XML_GetCurrentByteCount(parser);
+  length = size - offset;
+  if (length > reader->record_allocated) {
+    char *buffer = reader->record_buffer;
+    if (PyMem_Resize(buffer, char, length) == NULL) {
+      PyErr_NoMemory();
+      return EXPAT_STATUS_ERROR;
+    }
+    reader->record_buffer = buffer;
+    reader->record_allocated = length;
+  }
+  memcpy(reader->record_buffer, input + offset, length);
+  reader->record_start = 0;
+  reader->record_end = length;
+
+  return ExpatReader_Suspend(reader);
+}
+
 /* callback functions cannot be declared Py_LOCAL */
 static void expat_EndElement(ExpatReader *reader, const XML_Char *expat_name)
 {
@@ -2281,6 +2423,13 @@ static void expat_EndElement(ExpatReader *reader, const XML_Char *expat_name)
 
   temp = Stack_Pop(reader->preserve_whitespace_stack);
   Py_DECREF(temp);
+
+  /* the end of the document element ends the record */
+  if (ExpatReader_HasFlag(reader, ExpatReader_RECORDS) &&
+      reader->context->next == NULL && --reader->record_depth == 0) {
+    if (end_record(reader) == EXPAT_STATUS_ERROR)
+      stop_parsing(reader);
+  }
 }
 
 /** Expat CharacterData Handler ***************************************/
@@ -4021,6 +4170,12 @@ ExpatReader_Del(ExpatReader *reader)
     reader->name_cache = NULL;
   }
 
+  Py_CLEAR(reader->record_separator);
+  if (reader->record_buffer) {
+    PyMem_Del(reader->record_buffer);
+    reader->record_buffer = NULL;
+  }
+
   PyObject_FREE(reader);
 }
 
@@ -4075,17 +4230,17 @@ ExpatReader_GetWhitespaceStripping(ExpatReader *reader)
     return NULL;
   for (i = 0; i < size; i++) {
     WhitespaceRule *rule = &rules->items[i];
+    /* the rules are given as strip flags, the inverse of preserve_flag */
+    PyObject *flag = (rule->preserve_flag == Py_True) ? Py_False : Py_True;
     switch (rule->test_type) {
     case EXPANDED_NAME_TEST:
-      item = PyTuple_Pack(3, rule->test_namespace, rule->test_name,
-                          rule->preserve_flag);
+      item = PyTuple_Pack(3, rule->test_namespace, rule->test_name, flag);
       break;
     case NAMESPACE_TEST:
-      item = PyTuple_Pack(3, rule->test_namespace, asterisk_string,
-                          rule->preserve_flag);
+      item = PyTuple_Pack(3, rule->test_namespace, asterisk_string, flag);
       break;
     case ELEMENT_TEST:
-      item = PyTuple_Pack(3, Py_None, asterisk_string, rule->preserve_flag);
+      item = PyTuple_Pack(3, Py_None, asterisk_string, flag);
       break;
     default:
       PyErr_BadInternalCall();
@@ -4358,6 +4513,187 @@ ExpatReader_Resume(ExpatReader *reader)
   return continue_parsing(reader);
 }
 
+/** ExpatReader_ParseRecords ******************************************/
+
+/* Consume the whitespace and separator bytes preceding the next record,
+ * reading more input as needed.  Returns 1 if the next record has been
+ * found, 0 at the end of the input or -1 on error.
+ */
+Py_LOCAL_INLINE(int)
+skip_separators(ExpatReader *reader)
+{
+  Py_ssize_t (*read_func)(PyObject *, char *, int);
+  PyObject *read_arg;
+  const char *separator = PyString_AS_STRING(reader->record_separator);
+  size_t separator_size = PyString_GET_SIZE(reader->record_separator);
+  Py_ssize_t bytes_read;
+  char *p, *end;
+
+  get_read_func(reader, &read_func, &read_arg);
+  for (;;) {
+    p = reader->record_buffer + reader->record_start;
+    end = reader->record_buffer + reader->record_end;
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n' ||
+                       memchr(separator, *p, separator_size) != NULL))
+      p++;
+    reader->record_start = p - reader->record_buffer;
+    if (p < end)
+      return 1;
+
+    if (reader->record_allocated < RECORD_BUFSIZ) {
+      char *buffer = reader->record_buffer;
+      if (PyMem_Resize(buffer, char, RECORD_BUFSIZ) == NULL) {
+        PyErr_NoMemory();
+        return -1;
+      }
+      reader->record_buffer = buffer;
+      reader->record_allocated = RECORD_BUFSIZ;
+    }
+    bytes_read = read_func(read_arg, reader->record_buffer, RECORD_BUFSIZ);
+    if (bytes_read < 0)
+      return -1;
+    reader->record_start = 0;
+    reader->record_end = bytes_read;
+    if (bytes_read == 0)
+      return 0;
+  }
+}
+
+/* Parse a stream of back-to-back documents, optionally delimited by any of
+ * the bytes in `separator` (whitespace between documents is always
+ * skipped).  The handler receives a complete document (StartDocument
+ * through EndDocument) for each record.  Returns EXPAT_STATUS_SUSPENDED
+ * after each record; call ExpatReader_NextRecord() to parse the following
+ * one.  EXPAT_STATUS_OK is returned once the input is exhausted.
+ *
+ * Anything following a document element, other than the delimiters, is
+ * parsed as part of the prolog of the next record.
+ */
+ExpatStatus
+ExpatReader_ParseRecords(ExpatReader *reader, PyObject *source,
+                         PyObject *separator)
+{
+  XML_Parser parser;
+  ExpatStatus status;
+
+  Debug_FunctionCall(ExpatReader_ParseRecords, reader);
+
+  if (!PyString_Check(separator)) {
+    PyErr_Format(PyExc_TypeError, "separator must be a string, not %s",
+                 separator->ob_type->tp_name);
+    return EXPAT_STATUS_ERROR;
+  }
+
+  parser = create_parser(reader);
+  if (parser == NULL) {
+    return EXPAT_STATUS_ERROR;
+  }
+  status = begin_context(reader, parser, source);
+  if (status == EXPAT_STATUS_ERROR)
+    return status;
+  begin_handlers(reader, &expat_handlers);
+
+  ExpatReader_SetFlag(reader, ExpatReader_RECORDS);
+  Py_INCREF(separator);
+  Py_XDECREF(reader->record_separator);
+  reader->record_separator = separator;
+  reader->record_start = reader->record_end = 0;
+
+  status = ExpatReader_NextRecord(reader);
+
+  Debug_ReturnStatus(ExpatReader_ParseRecords, status);
+  return status;
+}
+
+ExpatStatus
+ExpatReader_NextRecord(ExpatReader *reader)
+{
+  Context *context = reader->context;
+  XML_Parser parser;
+  ExpatStatus status;
+  enum XML_Status xml_status;
+  void *buffer;
+  size_t length;
+
+  Debug_FunctionCall(ExpatReader_NextRecord, reader);
+
+  /* already exhausted */
+  if (context == NULL)
+    return EXPAT_STATUS_OK;
+
+  /* reset the parser (and per-document state) in place */
+  parser = context->parser;
+  if (XML_ParserReset(parser, NULL) != XML_TRUE) {
+    PyErr_NoMemory();
+    goto error;
+  }
+  init_parser(reader, parser);
+  setup_handlers(parser, context->handlers);
+  context->flags = 0;
+  if (ExpatReader_HasFlag(reader, ExpatReader_DTD_VALIDATION)) {
+    Expat_SetFlag(reader, EXPAT_FLAG_VALIDATE);
+  }
+  if (context->dtd) {
+    DTD_Del(context->dtd);
+    context->dtd = NULL;
+  }
+  reader->record_depth = 0;
+
+  switch (skip_separators(reader)) {
+  case 0:
+    destroy_contexts(reader);
+    Debug_ReturnStatus(ExpatReader_NextRecord, EXPAT_STATUS_OK);
+    return EXPAT_STATUS_OK;
+  case -1:
+    goto error;
+  }
+
+  if (prepare_parsing(reader) == EXPAT_STATUS_ERROR)
+    goto error;
+  if (ExpatHandler_StartDocument(context->handler) == EXPAT_STATUS_ERROR)
+    goto error;
+
+  /* parse the input left over from the previous record */
+  length = reader->record_end - reader->record_start;
+  buffer = XML_GetBuffer(parser, (int)length);
+  if (buffer == NULL) {
+    process_error(reader);
+    goto error;
+  }
+  memcpy(buffer, reader->record_buffer + reader->record_start, length);
+  reader->record_start = reader->record_end = 0;
+  xml_status = XML_ParseBuffer(parser, (int)length, 0);
+  switch (xml_status) {
+  case XML_STATUS_ERROR:
+    process_error(reader);
+    goto error;
+  case XML_STATUS_SUSPENDED:
+    status = EXPAT_STATUS_SUSPENDED;
+    break;
+  default:
+    status = continue_parsing(reader);
+    if (status == EXPAT_STATUS_ERROR)
+      goto error;
+  }
+
+  /* the document element has ended (the input being exhausted before
+   * then would have been reported as an error) */
+  if (reader->buffer_used) {
+    if (charbuf_flush(reader) == EXPAT_STATUS_ERROR)
+      goto error;
+  }
+  if (ExpatHandler_EndDocument(context->handler) == EXPAT_STATUS_ERROR)
+    goto error;
+
+  Debug_ReturnStatus(ExpatReader_NextRecord, EXPAT_STATUS_SUSPENDED);
+  return EXPAT_STATUS_SUSPENDED;
+
+error:
+  destroy_contexts(reader);
+  Debug_ReturnStatus(ExpatReader_NextRecord, EXPAT_STATUS_ERROR);
+  return EXPAT_STATUS_ERROR;
+}
+
 /** ExpatReader Locator Interface *************************************/
 
 PyObject *ExpatReader_GetBase(ExpatReader *reader)
@@ -4416,7 +4752,9 @@ static Expat_APIObject Expat_API = {
   ExpatReader_GetBase,
   ExpatReader_GetLineNumber,
   ExpatReader_GetColumnNumber,
-  Attributes_New
+  Attributes_New,
+  ExpatReader_ParseRecords,
+  ExpatReader_NextRecord,
 };
 
 struct submodule_t {
@@ -257,6 +257,10 @@ extern "C" {
     unsigned long (*Reader_GetColumnNumber)(ExpatReader *reader);
     PyObject *(*Attributes_New)(ExpatAttribute atts[], Py_ssize_t length);
 
+    ExpatStatus (*Reader_ParseRecords)(ExpatReader *reader, PyObject *source,
+                                       PyObject *separator);
+    ExpatStatus (*Reader_NextRecord)(ExpatReader *reader);
+
   } Expat_APIObject;
 
 #ifdef Expat_BUILDING_MODULE
@@ -293,6 +297,9 @@ extern "C" {
                                       PyObject *namespaces);
   ExpatStatus ExpatReader_Suspend(ExpatReader *reader);
   ExpatStatus ExpatReader_Resume(ExpatReader *reader);
+  ExpatStatus ExpatReader_ParseRecords(ExpatReader *reader, PyObject *source,
+                                       PyObject *separator);
+  ExpatStatus ExpatReader_NextRecord(ExpatReader *reader);
   int ExpatReader_GetParsingStatus(ExpatReader *reader);
   PyObject *Attributes_New(ExpatAttribute atts[], Py_ssize_t length);
 
@@ -319,6 +326,8 @@ extern "C" {
 #define ExpatReader_ParseEntity Expat_EXPORT(Reader_ParseEntity)
 #define ExpatReader_Suspend     Expat_EXPORT(Reader_Suspend)
 #define ExpatReader_Resume      Expat_EXPORT(Reader_Resume)
+#define ExpatReader_ParseRecords Expat_EXPORT(Reader_ParseRecords)
+#define ExpatReader_NextRecord  Expat_EXPORT(Reader_NextRecord)
 
 #define ExpatReader_GetBase         Expat_EXPORT(Reader_GetBase)
 #define ExpatReader_GetLineNumber   Expat_EXPORT(Reader_GetLineNumber)
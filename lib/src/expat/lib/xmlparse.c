@@ -4617,6 +4617,12 @@ epilogProcessor(XML_Parser parser,
 {
   processor = epilogProcessor;
   eventPtr = s;
+  /* parsing may have been suspended by the end element handler of the
+     document element (as fixed in later Expat releases) */
+  if (ps_parsing == XML_SUSPENDED) {
+    *nextPtr = s;
+    return XML_ERROR_NONE;
+  }
   for (;;) {
     const char *next = NULL;
     int tok = XmlPrologTok(encoding, s, end, &next);
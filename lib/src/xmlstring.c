@@ -851,6 +851,208 @@ static PyObject *string_splitqname(PyObject *self, PyObject *args)
   return result;
 }
 
+static char normalizespace_doc[] =
+"normalizespace(S) -> unicode\n\
+\n\
+Return a copy of the string S with leading and trailing whitespace removed\n\
+and runs of whitespace replaced by a single space (XPath normalize-space).";
+
+static PyObject *string_normalizespace(PyObject *self, PyObject *args)
+{
+  PyObject *str, *result;
+
+  if (!PyArg_ParseTuple(args, "O:normalizespace", &str))
+    return NULL;
+
+  str = PyUnicode_FromObject(str);
+  if (str == NULL)
+    return NULL;
+  result = NormalizeSpace(str);
+  Py_DECREF(str);
+  return result;
+}
+
+/* Compiled translation tables keyed by the (from, to) strings.  Stylesheets
+ * almost always call translate() with constant arguments, so this stays
+ * small; it is simply emptied when it gets too large. */
+#define TRANSLATE_CACHE_MAX 100
+static PyObject *translate_cache;
+
+static PyObject *GetTranslateTable(PyObject *from, PyObject *to)
+{
+  PyObject *key, *table, *value;
+  Py_UNICODE *p = PyUnicode_AS_UNICODE(from);
+  Py_ssize_t i, from_len = PyUnicode_GET_SIZE(from);
+  Py_ssize_t to_len = PyUnicode_GET_SIZE(to);
+
+  key = PyTuple_Pack(2, from, to);
+  if (key == NULL)
+    return NULL;
+  table = PyDict_GetItem(translate_cache, key);
+  if (table) {
+    Py_DECREF(key);
+    Py_INCREF(table);
+    return table;
+  }
+
+  table = PyDict_New();
+  if (table == NULL) {
+    Py_DECREF(key);
+    return NULL;
+  }
+  for (i = 0; i < from_len; i++) {
+    PyObject *ch = PyInt_FromLong(p[i]);
+    if (ch == NULL)
+      goto error;
+    /* the first occurrence of a character determines its replacement */
+    if (PyDict_GetItem(table, ch) == NULL) {
+      if (i < to_len) {
+        value = PyInt_FromLong(PyUnicode_AS_UNICODE(to)[i]);
+        if (value == NULL) {
+          Py_DECREF(ch);
+          goto error;
+        }
+      } else {
+        /* no replacement; the character is removed */
+        Py_INCREF(Py_None);
+        value = Py_None;
+      }
+      if (PyDict_SetItem(table, ch, value) < 0) {
+        Py_DECREF(ch);
+        Py_DECREF(value);
+        goto error;
+      }
+      Py_DECREF(value);
+    }
+    Py_DECREF(ch);
+  }
+
+  if (PyDict_Size(translate_cache) >= TRANSLATE_CACHE_MAX)
+    PyDict_Clear(translate_cache);
+  if (PyDict_SetItem(translate_cache, key, table) < 0)
+    goto error;
+  Py_DECREF(key);
+  return table;
+
+error:
+  Py_DECREF(key);
+  Py_DECREF(table);
+  return NULL;
+}
+
+static char translate_doc[] =
+"translate(S, from, to) -> unicode\n\
+\n\
+Return a copy of the string S with each character in `from` replaced by\n\
+the character at the same position in `to`, or removed if there is no\n\
+such character (XPath translate).";
+
+static PyObject *string_translate(PyObject *self, PyObject *args)
+{
+  PyObject *str, *from, *to, *table, *result;
+
+  if (!PyArg_ParseTuple(args, "OOO:translate", &str, &from, &to))
+    return NULL;
+
+  str = PyUnicode_FromObject(str);
+  if (str == NULL)
+    return NULL;
+  from = PyUnicode_FromObject(from);
+  if (from == NULL) {
+    Py_DECREF(str);
+    return NULL;
+  }
+  if (PyUnicode_GET_SIZE(str) == 0 || PyUnicode_GET_SIZE(from) == 0) {
+    Py_DECREF(from);
+    return str;
+  }
+  to = PyUnicode_FromObject(to);
+  if (to == NULL) {
+    Py_DECREF(str);
+    Py_DECREF(from);
+    return NULL;
+  }
+  table = GetTranslateTable(from, to);
+  Py_DECREF(from);
+  Py_DECREF(to);
+  if (table == NULL) {
+    Py_DECREF(str);
+    return NULL;
+  }
+  result = PyUnicode_TranslateCharmap(PyUnicode_AS_UNICODE(str),
+                                      PyUnicode_GET_SIZE(str), table,
+                                      "ignore");
+  Py_DECREF(table);
+  Py_DECREF(str);
+  return result;
+}
+
+static char substring_doc[] =
+"substring(S, start[, length]) -> unicode\n\
+\n\
+Return the substring of the string S starting at the (1-based, rounded)\n\
+position `start`, with `length` characters or to the end of the string\n\
+(XPath substring).";
+
+static PyObject *string_substring(PyObject *self, PyObject *args)
+{
+  PyObject *str;
+  double start, length, end;
+  Py_ssize_t size;
+  int has_length;
+
+  length = 0;
+  if (!PyArg_ParseTuple(args, "Od|d:substring", &str, &start, &length))
+    return NULL;
+  has_length = PyTuple_GET_SIZE(args) > 2;
+
+  str = PyUnicode_FromObject(str);
+  if (str == NULL)
+    return NULL;
+  size = PyUnicode_GET_SIZE(str);
+
+  /* start == NaN: spec doesn't say; assume no substring to return
+   * start == +Inf or -Inf: no substring to return */
+  if (!Py_IS_FINITE(start))
+    goto empty;
+  start = round(start);
+
+  if (!has_length) {
+    end = (double)size;
+  } else if (Py_IS_NAN(length)) {
+    /* length == NaN: spec doesn't say; assume no substring to return */
+    goto empty;
+  } else if (Py_IS_INFINITY(length)) {
+    /* length == +Inf: return chars to end;
+     * length == -Inf: no substring to return */
+    if (length < 0)
+      goto empty;
+    end = (double)size;
+  } else {
+    /* the substring must end before position (start+length) which is
+     * (start+length-1) as a 0-based index */
+    end = start + round(length) - 1;
+  }
+  /* convert to a 0-based index */
+  start = start < 1 ? 0 : start - 1;
+  if (end > size)
+    end = (double)size;
+  if (end <= start)
+    goto empty;
+  if (start == 0 && end == size)
+    return str;
+  {
+    PyObject *result = PySequence_GetSlice(str, (Py_ssize_t)start,
+                                           (Py_ssize_t)end);
+    Py_DECREF(str);
+    return result;
+  }
+
+empty:
+  Py_DECREF(str);
+  return PyUnicode_FromUnicode(NULL, 0);
+}
+
 /** Module Initialization *********************************************/
 
 static PyMethodDef module_methods[] = {
@@ -864,6 +1066,10 @@ static PyMethodDef module_methods[] = {
   { "isqname",    string_isqname,    METH_VARARGS, isqname_doc },
   { "isncname",   string_isncname,   METH_VARARGS, isncname_doc },
   { "splitqname", string_splitqname, METH_VARARGS, splitqname_doc },
+  { "normalizespace", string_normalizespace, METH_VARARGS,
+    normalizespace_doc },
+  { "translate",  string_translate,  METH_VARARGS, translate_doc },
+  { "substring",  string_substring,  METH_VARARGS, substring_doc },
   { NULL, NULL }
 };
 
@@ -891,6 +1097,9 @@ DL_EXPORT(void) init_xmlstring(void)
   module = Py_InitModule3(XmlString_MODULE_NAME, module_methods, module_doc);
   if (module == NULL) return;
 
+  translate_cache = PyDict_New();
+  if (translate_cache == NULL) return;
+
   /* Export C API */
   capi = PyCObject_FromVoidPtr((void *)&XmlString_API, NULL);
   if (capi) PyModule_AddObject(module, "CAPI", capi);
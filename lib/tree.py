@@ -4,10 +4,11 @@
 A very fast tree (node API) library for XML processing with sensible conventions.
 """
 
-__all__ = ["parse", 'node', 'entity', 'element', 'attribute', 'comment', 'processing_instruction', 'text']
+__all__ = ["parse", "parse_records", 'node', 'entity', 'element', 'attribute', 'comment', 'processing_instruction', 'text']
 
 from amara._domlette import *
 from amara._domlette import parse as _parse
+from amara._domlette import parse_records as _parse_records
 from amara.lib import inputsource
 
 #node = Node
@@ -68,6 +69,44 @@ def parse(obj, uri=None, entity_factory=None, standalone=False, validate=False,
         flags = PARSE_FLAGS_EXTERNAL_ENTITIES
     return _parse(inputsource(obj, uri), flags, entity_factory=entity_factory,rule_handler=rule_handler)
 
+def parse_records(obj, separator='', uri=None, entity_factory=None, standalone=False, validate=False):
+    '''
+    Parse a stream of back-to-back XML documents (records), returning an iterator
+    over a tree for each one
+
+    Records may be separated by whitespace and by any of the characters in
+    `separator` (e.g. '\\f' for form feed delimited records).  The same
+    parser is reset in place for each record, so this is much faster than
+    splitting the input and calling `parse()` on each piece.
+
+    :param obj: object with "text" to parse, as for `parse()`
+    :param separator: characters (bytes) that may delimit records
+    :type separator: string
+    :param uri: optional URI used as the base URI of each record
+    :return: iterator of parsed tree objects
+    :raises `amara.ReaderError`: If a record is not well formed.  Line and column
+        numbers are relative to the start of the record
+
+    Comments and processing instructions following a document element are
+    parsed as part of the next record.  The other parameters are as for
+    `parse()`.
+
+    Examples:
+
+    >>> import amara
+    >>> records = '<a>1</a>\\f<b>2</b>\\n<c>3</c>'
+    >>> [ doc.xml_select(u'name(*)') for doc in amara.tree.parse_records(records, '\\f') ]
+    [u'a', u'b', u'c']
+
+    '''
+    if standalone:
+        flags = PARSE_FLAGS_STANDALONE
+    elif validate:
+        flags = PARSE_FLAGS_VALIDATE
+    else:
+        flags = PARSE_FLAGS_EXTERNAL_ENTITIES
+    return _parse_records(inputsource(obj, uri), flags, separator=separator, entity_factory=entity_factory)
+
 #Rest of the functions are deprecated, and will be removed soon
 
 def NonvalParse(isrc, readExtDtd=True, nodeFactories=None):
@@ -118,6 +118,169 @@ static int complete_text(TreeWriterObject *self)
   return 0;
 }
 
+/* Appends `data` to the pending text, completing the pending text first if
+ * its escaping differs. */
+static int write_text(TreeWriterObject *self, PyObject *data,
+                      int escape_output)
+{
+  Py_UNICODE *buffer = self->buffer;
+  Py_ssize_t size;
+
+  /* If there is nothing to write, return */
+  if (PyUnicode_GET_SIZE(data) == 0)
+    return 0;
+
+  /* If disable-output-escaping isn't the same as the previous text,
+   * store the previous and start fresh. */
+  if (escape_output != self->escape_output) {
+    if (self->buffer_size && complete_text(self) < 0)
+      return -1;
+    self->escape_output = escape_output;
+  }
+
+  /* Grow the buffer if there isn't enough room for the new characters. */
+  size = self->buffer_size + PyUnicode_GET_SIZE(data);
+  if (size > self->buffer_allocated) {
+    Py_ssize_t allocated = ROUND_UP(size, CDATA_BUFSIZ);
+    if (PyMem_Resize(buffer, Py_UNICODE, allocated) == NULL) {
+      PyErr_NoMemory();
+      return -1;
+    }
+    self->buffer = buffer;
+    self->buffer_allocated = allocated;
+  }
+  buffer += self->buffer_size;
+
+  /* store the new data */
+  Py_UNICODE_COPY(buffer, PyUnicode_AS_UNICODE(data), PyUnicode_GET_SIZE(data));
+  self->buffer_size = size;
+  return 0;
+}
+
+static int write_attribute(TreeWriterObject *self, PyObject *namespace,
+                           PyObject *name, PyObject *localName,
+                           PyObject *value)
+{
+  AttrObject *attr;
+
+  /* From XSLT 1.0 Section 7.1.3 (we implement recovery here,
+   * if processing gets this far):
+   * - Adding an attribute to an element after children have been added
+   *   to it; implementations may either signal the error or ignore the
+   *   attribute.
+   * - Adding an attribute to a node that is not an element;
+   *   implementations may either signal the error or ignore the
+   *   attribute. */
+  if (Element_Check(self->current_node) &&
+      Container_GET_COUNT(self->current_node) == 0) {
+    attr = Element_AddAttribute((ElementObject *)self->current_node,
+                                namespace, name, localName, value);
+    if (attr == NULL) return -1;
+    Py_DECREF(attr);
+  }
+  return 0;
+}
+
+static int append_node(TreeWriterObject *self, NodeObject *node)
+{
+  int rc;
+  if (node == NULL) return -1;
+  rc = Container_Append(self->current_node, node);
+  Py_DECREF(node);
+  return rc;
+}
+
+/* Copies `node` (and its descendants) to the current position in the
+ * result.  This is equivalent to generating the corresponding output
+ * events, but builds the nodes directly from the source subtree. */
+static int copy_node(TreeWriterObject *self, NodeObject *node)
+{
+  Py_ssize_t i, pos;
+
+  if (Element_Check(node)) {
+    ElementObject *element;
+    PyObject *nodemap;
+    NamespaceObject *nsattr;
+    AttrObject *attr;
+    int rc = 0;
+
+    if (self->buffer_size && complete_text(self) < 0) return -1;
+    element = Element_New(Element_NAMESPACE_URI(node), Element_QNAME(node),
+                          Element_LOCAL_NAME(node));
+    if (element == NULL) return -1;
+    if (Container_Append(self->current_node, (NodeObject *)element) < 0) {
+      Py_DECREF(element);
+      return -1;
+    }
+    /* Let the parent own the reference to it. */
+    Py_DECREF(element);
+
+    nodemap = Element_NAMESPACES(node);
+    if (nodemap) {
+      pos = 0;
+      while ((nsattr = NamespaceMap_Next(nodemap, &pos))) {
+        nsattr = Element_AddNamespace(element, Namespace_GET_NAME(nsattr),
+                                      Namespace_GET_VALUE(nsattr));
+        if (nsattr == NULL) return -1;
+        Py_DECREF(nsattr);
+      }
+    }
+    nodemap = Element_ATTRIBUTES(node);
+    if (nodemap) {
+      pos = 0;
+      while ((attr = AttributeMap_Next(nodemap, &pos))) {
+        attr = Element_AddAttribute(element, Attr_GET_NAMESPACE_URI(attr),
+                                    Attr_GET_QNAME(attr),
+                                    Attr_GET_LOCAL_NAME(attr),
+                                    Attr_GET_VALUE(attr));
+        if (attr == NULL) return -1;
+        Py_DECREF(attr);
+      }
+    }
+
+    if (Py_EnterRecursiveCall(" in copy_node"))
+      return -1;
+    self->current_node = (NodeObject *)element;
+    for (i = 0; i < Container_GET_COUNT(node) && rc == 0; i++) {
+      rc = copy_node(self, Container_GET_CHILD(node, i));
+    }
+    if (rc == 0 && self->buffer_size)
+      rc = complete_text(self);
+    self->current_node = Node_GET_PARENT(element);
+    Py_LeaveRecursiveCall();
+    return rc;
+  }
+  else if (Text_Check(node)) {
+    return write_text(self, CharacterData_GET_VALUE(node),
+                      node->ob_type != &UnescapedText_Type);
+  }
+  else if (Entity_Check(node)) {
+    for (i = 0; i < Container_GET_COUNT(node); i++) {
+      if (copy_node(self, Container_GET_CHILD(node, i)) < 0)
+        return -1;
+    }
+    return 0;
+  }
+  else if (Attr_Check(node)) {
+    return write_attribute(self, Attr_GET_NAMESPACE_URI(node),
+                           Attr_GET_QNAME(node), Attr_GET_LOCAL_NAME(node),
+                           Attr_GET_VALUE(node));
+  }
+  else if (Comment_Check(node)) {
+    if (self->buffer_size && complete_text(self) < 0) return -1;
+    return append_node(self,
+                       (NodeObject *)Comment_New(CharacterData_GET_VALUE(node)));
+  }
+  else if (ProcessingInstruction_Check(node)) {
+    if (self->buffer_size && complete_text(self) < 0) return -1;
+    return append_node(self, (NodeObject *)ProcessingInstruction_New(
+                               ProcessingInstruction_GET_TARGET(node),
+                               ProcessingInstruction_GET_DATA(node)));
+  }
+  /* namespace nodes are not represented in the result tree */
+  return 0;
+}
+
 /** Public C API ******************************************************/
 
 
@@ -325,18 +488,10 @@ static PyObject *treewriter_attribute(TreeWriterObject *self,
     return NULL;
   }
 
-  /* From XSLT 1.0 Section 7.1.3 (we implement recovery here,
-   * if processing gets this far):
-   * - Adding an attribute to an element after children have been added
-   *   to it; implementations may either signal the error or ignore the
-   *   attribute.
-   * - Adding an attribute to a node that is not an element;
-   *   implementations may either signal the error or ignore the
-   *   attribute. */
   if (Element_Check(self->current_node) &&
       Container_GET_COUNT(self->current_node) == 0) {
     PyObject *prefix, *localName;
-    AttrObject *attr;
+    int rc;
 
     name = XmlString_ConvertArgument(name, "name", 0);
     if (name == NULL) {
@@ -368,13 +523,12 @@ static PyObject *treewriter_attribute(TreeWriterObject *self,
     }
     Py_DECREF(prefix);
 
-    attr = Element_AddAttribute((ElementObject *)self->current_node,
-                                namespace, name, localName, value);
+    rc = write_attribute(self, namespace, name, localName, value);
     Py_DECREF(name);
     Py_DECREF(value);
     Py_DECREF(namespace);
-    if (attr == NULL) return NULL;
-    Py_DECREF(attr);
+    Py_DECREF(localName);
+    if (rc < 0) return NULL;
   }
 
   Py_INCREF(Py_None);
@@ -384,8 +538,6 @@ static PyObject *treewriter_attribute(TreeWriterObject *self,
 static PyObject *treewriter_text(TreeWriterObject *self, PyObject *args,
                                  PyObject *kwds)
 {
-  Py_UNICODE *buffer = self->buffer;
-  Py_ssize_t size;
   int escape_output;
   PyObject *data, *disable_escaping=Py_False;
   static char *kwlist[] = { "data", "disable_escaping", NULL };
@@ -400,44 +552,18 @@ static PyObject *treewriter_text(TreeWriterObject *self, PyObject *args,
     return NULL;
   }
 
+  escape_output = PyObject_Not(disable_escaping);
+  if (escape_output < 0)
+    return NULL;
+
   data = XmlString_ConvertArgument(data, "data", 0);
   if (data == NULL) return NULL;
 
-  /* If there is nothing to write, return */
-  if (PyUnicode_GET_SIZE(data) == 0) {
+  if (write_text(self, data, escape_output) < 0) {
     Py_DECREF(data);
-    Py_INCREF(Py_None);
-    return Py_None;
-  }
-
-  /* If disable-output-escaping isn't the same as the previous text,
-   * store the previous and start fresh. */
-  escape_output = PyObject_Not(disable_escaping);
-  if (escape_output != self->escape_output) {
-    if (escape_output < 0 || (self->buffer_size && complete_text(self) < 0)) {
-      Py_DECREF(data);
-      return NULL;
-    }
-    self->escape_output = escape_output;
-  }
-
-  /* Grow the buffer if there isn't enough room for the new characters. */
-  size = self->buffer_size + PyUnicode_GET_SIZE(data);
-  if (size > self->buffer_allocated) {
-    Py_ssize_t allocated = ROUND_UP(size, CDATA_BUFSIZ);
-    if (PyMem_Resize(buffer, Py_UNICODE, allocated) == NULL) {
-      PyErr_NoMemory();
-      Py_DECREF(data);
-      return NULL;
-    }
-    self->buffer = buffer;
-    self->buffer_allocated = allocated;
+    return NULL;
   }
-  buffer += self->buffer_size;
-
-  /* store the new data */
-  Py_UNICODE_COPY(buffer, PyUnicode_AS_UNICODE(data), PyUnicode_GET_SIZE(data));
-  self->buffer_size = size;
+  Py_DECREF(data);
 
   Py_INCREF(Py_None);
   return Py_None;
@@ -524,6 +650,26 @@ static PyObject *treewriter_comment(TreeWriterObject *self, PyObject *args,
   return Py_None;
 }
 
+static PyObject *treewriter_copy_node(TreeWriterObject *self, PyObject *node)
+{
+  if (self->current_node == NULL) {
+    PyErr_SetString(PyExc_RuntimeError, "end_document already called");
+    return NULL;
+  }
+
+  if (!Node_Check(node)) {
+    PyErr_Format(PyExc_TypeError, "copy_node() argument must be a node, not %s",
+                 node->ob_type->tp_name);
+    return NULL;
+  }
+
+  if (copy_node(self, (NodeObject *)node) < 0)
+    return NULL;
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
 #define TreeWriter_METHOD(NAME, ARGSPEC) \
   { #NAME, (PyCFunction) treewriter_##NAME, ARGSPEC, NULL }
 
@@ -537,6 +683,7 @@ static struct PyMethodDef treewriter_methods[] = {
   TreeWriter_METHOD(text, METH_KEYWORDS),
   TreeWriter_METHOD(processing_instruction, METH_KEYWORDS),
   TreeWriter_METHOD(comment, METH_KEYWORDS),
+  TreeWriter_METHOD(copy_node, METH_O),
   { NULL }
 };
 
@@ -15,7 +15,9 @@ Note: this module has some departures from the reguler PEP 8 naming convention
 for considered reasons of clarity in use
 """
 
+import re
 import sys
+import cStringIO
 from itertools import *
 import amara
 from amara.lib.util import coroutine
@@ -121,80 +123,127 @@ class structwriter(object):
 
         See documentation for other proxy node classes
         """
-        prefixes = prefixes or {}
-        if isinstance(obj, ROOT):
-            self.printer.start_document()
-            for subobj in obj.content:
-                self.feed(subobj)
-            self.printer.end_document()
-            return
-        if isinstance(obj, NS):
-            return
-        if isinstance(obj, RAW):
-            doc = amara.parse(obj.content)
-            from amara.writers._treevisitor import visitor
-            v = visitor(printer=self.printer)
-            for child in doc.xml_children:
-                v.visit(child)
-            return
-        if isinstance(obj, E):
-            #First attempt used tee.  Seems we ran into the warning at
-            #http://www.python.org/doc/2.4.3/whatsnew/node13.html
-            #"Note that tee() has to keep copies of the values returned by the iterator;
-            #in the worst case, it may need to keep all of them.
-            #This should therefore be used carefully if the leading iterator can run
-            #far ahead of the trailing iterator in a long stream of inputs.
-            #If the separation is large, then you might as well use list() instead.
-            #When the iterators track closely with one another, tee()" is ideal. Possible
-            #applications include bookmarking, windowing, or lookahead iterators.
-            #(Contributed by Raymond Hettinger.)"
-            #obj.namespaces = {}
-            new_prefixes = []
-            lead = None
-            content = iter(obj.content)
-            for subobj in content:
-                if isinstance(subobj, NS):
-                    new_prefixes.append((subobj.prefix, subobj.namespace))
-                else:
-                    lead = subobj
+        #The structure is walked with an explicit stack rather than by
+        #recursion, so arbitrarily deep structures can be fed and the per-item
+        #overhead stays low.  Each stack entry is (pending items, in-scope
+        #prefixes, end event).  The prefix mappings are shared by all the
+        #elements in their scope, and never modified once created.
+        printer = self.printer
+        start_element, end_element, text = (
+            printer.start_element, printer.end_element, printer.text)
+        stack = []
+        push, pop = stack.append, stack.pop
+        items = iter((obj,))
+        scope = prefixes or {}
+        while True:
+            for obj in items:
+                kind = type(obj)
+                if kind is unicode:
+                    text(obj)
+                elif kind is E or isinstance(obj, E):
+                    content = obj.content
+                    new_prefixes = []
+                    if (type(content) is tuple and content and content[0]
+                        and not isinstance(content[0], NS)):
+                        content = iter(content)
+                    else:
+                        #Namespace declarations lead the content
+                        content = iter(content)
+                        for lead in content:
+                            if isinstance(lead, NS):
+                                new_prefixes.append((lead.prefix, lead.namespace))
+                            else:
+                                #A false first child means an empty element
+                                content = chain((lead,), content) if lead else ()
+                                break
+                    qname, ns = obj.qname, obj.ns
+                    prefix = splitqname(qname)[0] or u''
+                    if ns == UNSPECIFIED_NAMESPACE:
+                        ns = scope.get(prefix, u'')
+                    else:
+                        ns = ns or u''
+                        if scope.get(prefix) != ns:
+                            new_prefixes.append((prefix, ns))
+                    attrs = obj.attributes.values() if obj.attributes else ()
+                    start_element(ns, qname, new_prefixes, attrs)
+                    push((items, scope, (ns, qname)))
+                    if new_prefixes:
+                        scope = scope.copy()
+                        scope.update(new_prefixes)
+                    items = content
+                    break
+                elif isinstance(obj, basestring):
+                    text(U(obj))
+                elif kind is NS:
+                    pass
+                elif isinstance(obj, tree.element):
+                    #Be smart about bindery nodes
+                    text(unicode(obj))
+                elif isinstance(obj, RAW):
+                    self._raw(obj, scope)
+                elif isinstance(obj, ROOT):
+                    printer.start_document()
+                    push((items, scope, None))
+                    items, scope = iter(obj.content), {}
+                    break
+                elif not isinstance(obj, NS):
+                    try:
+                        obj = iter(obj)
+                    except TypeError:
+                        if callable(obj):
+                            obj = iter((obj(),))
+                        else:
+                            #Just try to make it text, i.e. punt
+                            text(unicode(obj))
+                            continue
+                    push((items, scope, ()))
+                    items = obj
                     break
-
-            prefix, local = splitqname(obj.qname)
-            prefix = prefix or u''
-            if obj.ns == UNSPECIFIED_NAMESPACE:
-                obj.ns = prefixes.get(prefix, u'')
-            elif prefix not in prefixes or prefixes[prefix] != obj.ns:
-                new_prefixes.append((prefix, obj.ns or u''))
-            attrs = [ a for a in obj.attributes.itervalues() ] if obj.attributes else ()
-            if new_prefixes:
-                prefixes = prefixes.copy()
-                prefixes.update(dict(new_prefixes))
-            self.printer.start_element(obj.ns, obj.qname, new_prefixes, attrs)
-            if lead:
-                self.feed(lead, prefixes)
-                for subobj in content:
-                    self.feed(subobj, prefixes)
-            self.printer.end_element(obj.ns, obj.qname)
-            return
-
-        if isinstance(obj, basestring):
-            self.printer.text(U(obj))
-            return
-        if isinstance(obj, tree.element):
-            #Be smart about bindery nodes
-            self.printer.text(unicode(obj))
-            return
-        try:
-            obj = iter(obj)
-        except TypeError, e:
-            if callable(obj):
-                self.feed(obj(), prefixes)
             else:
-                #Just try to make it text, i.e. punt
-                self.feed(unicode(obj), prefixes)
-        else:
-            for subobj in obj:
-                self.feed(subobj, prefixes)
+                #The current items are exhausted
+                if not stack:
+                    return
+                items, scope, end = pop()
+                if end:
+                    end_element(*end)
+                elif end is None:
+                    printer.end_document()
+
+    def _raw(self, obj, prefixes):
+        printer = self.printer
+        content = obj.content
+        subset = None
+        if content[:2] in (u'<?', u'<!'):
+            match = _PROLOG.match(content)
+            subset = match.group('subset')
+            content = content[match.end():]
+        if subset is None and not isinstance(
+            printer, (_xmlprinters.xmlprettyprinter,
+                      _htmlprinters.htmlprettyprinter)):
+            #Passed through as is
+            printer.text(content, True)
+            return
+        #Reserialized, so that entities declared in the internal subset are
+        #expanded and the content is indented along with the rest.  The
+        #content is parsed as the children of a wrapper element declaring the
+        #prefixes in scope.
+        nsdecls = u''.join(
+            [ u' xmlns%s="%s"' % (prefix and u':' + prefix or u'',
+                                  _escape_attribute(namespace))
+              for prefix, namespace in prefixes.iteritems()
+              if namespace or not prefix ])
+        wrapped = u'<raw%s>%s</raw>' % (nsdecls, content)
+        if subset:
+            wrapped = u'<!DOCTYPE raw %s>%s' % (subset, wrapped)
+        doc = amara.parse(wrapped.encode('utf-8'))
+        from amara.writers._treevisitor import visitor
+        v = visitor(printer=printer)
+        #The declarations in scope need not be repeated
+        v._namespaces[-1].update(
+            [ (prefix or None, namespace)
+              for prefix, namespace in prefixes.iteritems() ])
+        for child in doc.xml_first_child.xml_children:
+            v.visit(child)
         return
 
     @coroutine
@@ -243,11 +292,7 @@ class structwriter(object):
         if isinstance(obj, NS):
             return
         if isinstance(obj, RAW):
-            doc = amara.parse(obj.content)
-            from amara.writers._treevisitor import visitor
-            v = visitor(printer=self.printer)
-            for child in doc.xml_children:
-                v.visit(child)
+            self._raw(obj, prefixes)
             return
         if isinstance(obj, E_CURSOR):
             new_prefixes = []
@@ -409,24 +454,32 @@ class structencoder(structwriter):
     See documentation for more extensive examples.
     """
     def __init__(self, **kwargs):
-        self.chunks = []
-        structwriter.__init__(self, stream=self, **kwargs)
+        #A cStringIO buffer is written to natively by the printer
+        self._buffer = cStringIO.StringIO()
+        structwriter.__init__(self, stream=self._buffer, **kwargs)
 
     def write(self, chunk):
-        self.chunks.append(chunk)
+        self._buffer.write(chunk)
 
     def read(self):
-        chunks = self.chunks
-        self.chunks = []
-        return ''.join(chunks)
+        buffer = self._buffer
+        result = buffer.getvalue()
+        buffer.seek(0)
+        buffer.truncate()
+        return result
+
+
+def _U(s):
+    #U() for the (usual) case of names and values given as unicode
+    return s if type(s) is unicode else U(s)
 
 
 class E(object):
     def __init__(self, name, *items):
         if isinstance(name, tuple):
-            self.ns, self.qname = imap(U, name)
+            self.ns, self.qname = imap(_U, name)
         else:
-            self.ns, self.qname = UNSPECIFIED_NAMESPACE, U(name)
+            self.ns, self.qname = UNSPECIFIED_NAMESPACE, _U(name)
         if items and isinstance(items[0], dict):
             attributes = items[0]
             self.content = items[1:]
@@ -439,11 +492,11 @@ class E(object):
             self.attributes = {}
             for name, value in attributes.iteritems():
                 if isinstance(name, tuple):
-                    ns, qname = imap(U, name)
+                    ns, qname = imap(_U, name)
                 else:
-                    ns, qname = None, U(name)
+                    ns, qname = None, _U(name)
                 #Unicode value coercion to help make it a bit smarter
-                self.attributes[ns, qname] = qname, U(value)
+                self.attributes[ns, qname] = qname, _U(value)
 
 
 class E_CURSOR(E):
@@ -469,8 +522,30 @@ class NS(object):
         self.namespace = namespace
 
 
+#The XML declaration and document type declaration of RAW content, with
+#the internal subset of the latter
+_PROLOG = re.compile(ur'(?:<\?xml\s.*?\?>\s*)?'
+                     ur'(?:<!DOCTYPE\s[^\[>]*(?P<subset>\[.*?\])?\s*>\s*)?',
+                     re.S)
+
+def _escape_attribute(value):
+    return value.replace(u'&', u'&amp;').replace(u'<', u'&lt;').replace(
+        u'"', u'&quot;')
+
 class RAW(object):
     '''
+    Markup to be written to the output.  It must be well-formed XML content
+    (text and/or elements) in the context where it appears, optionally
+    preceded by an XML declaration and a document type declaration; any
+    namespace prefixes in it are resolved by the declarations in scope
+    there.  Byte strings are taken to be UTF-8.
+
+    The content is written as is, without being parsed or checked, unless
+    the document type declaration has an internal subset (whose entities
+    are then expanded) or the output is indented (so that it is indented
+    along with the rest of the output).  In those cases it is parsed and
+    reserialized.
+
     >>> from amara.writers.struct import *
     >>> w = structwriter(indent=u"yes").feed(ROOT(
       E((u'urn:x-bogus1', u'n:a'), {(u'urn:x-bogus1', u'n:x'): u'1'},
@@ -479,8 +554,7 @@ class RAW(object):
     
     '''
     def __init__(self, *content):
-        #Eventually use incremental parse and feed()
-        self.content = ''.join(content)
+        self.content = u''.join(imap(_U, content))
 
 class ROOT(object):
     def __init__(self, *content):
@@ -150,6 +150,7 @@ class context(writer):
         (self.start_document, self.end_document, self.start_element,
          self.end_element, self.namespace, self.attribute, self.text,
          self.comment, self.processing_instruction) = _writer_methods(writer)
+        self._set_copy_node(writer)
         # begin processing
         writer.start_document()
         return
@@ -172,21 +173,38 @@ class context(writer):
             self.end_element, self.namespace, self.attribute, self.text,
             self.comment, self.processing_instruction
             ) = _writer_methods(self._writers[-1])
+            self._set_copy_node(self._writers[-1])
         return writer
 
+    def _set_copy_node(self, writer):
+        # use the writer's native subtree copy, if it has one.  The fallback
+        # is the class attribute, as storing a bound method of `self` on
+        # `self` would make every context a reference cycle.
+        try:
+            self.copy_node = writer.copy_node
+        except AttributeError:
+            self.__dict__.pop('copy_node', None)
+        return
+
     def copy_nodes(self, nodes):
+        copy_node = self.copy_node
         for node in nodes:
-            self.copy_node(node)
+            copy_node(node)
         return
 
     def copy_node(self, node):
+        return self._copy_node(node)
+
+    def _copy_node(self, node):
+        # Generates the output events for `node`, for writers that do not
+        # provide their own `copy_node()`.
         if isinstance(node, tree.element):
             self.start_element(node.xml_qname, node.xml_namespace,
                                node.xmlns_attributes.copy())
             for attr in node.xml_attributes.nodes():
                 self.attribute(attr.xml_qname, attr.xml_value, attr.xml_namespace)
             for child in node:
-                self.copy_node(child)
+                self._copy_node(child)
             self.end_element(node.xml_qname, node.xml_namespace)
         elif isinstance(node, tree.attribute):
             self.attribute(node.xml_qname, node.xml_value, node.xml_namespace)
@@ -198,7 +216,7 @@ class context(writer):
             self.comment(node.xml_value)
         elif isinstance(node, tree.entity):
             for child in node:
-                self.copy_node(child)
+                self._copy_node(child)
         elif isinstance(node, tree.namespace):
             self.namespace(node.xml_name, node.xml_value)
         else:
@@ -3,8 +3,7 @@
 """
 The implementation of the core sting functions from XPath 1.0.
 """
-import itertools
-
+from amara import _xmlstring
 from amara.xpath import datatypes
 from amara.xpath.functions import builtin_function
 
@@ -121,42 +120,10 @@ class substring_function(builtin_function):
         string = string.evaluate_as_string(context)
         start = start.evaluate_as_number(context)
 
-        # start == NaN: spec doesn't say; assume no substring to return
-        # start == +Inf or -Inf: no substring to return
-        if not start.isfinite():
-            return datatypes.EMPTY_STRING
-
-        # start is finite, safe for int() and round().
-        start = int(round(start))
-        # convert to 0-based index for python string slice
-        if start < 1:
-            startidx = 0
-        else:
-            startidx = start - 1
-
-        # length undefined: return chars startidx to end
         if length is None:
-            return datatypes.string(string[startidx:])
-
+            return datatypes.string(_xmlstring.substring(string, start))
         length = length.evaluate_as_number(context)
-        if not length.isfinite():
-            # length == +Inf: return chars startidx to end
-            if length > 0:
-                assert length.isinf()
-                return datatypes.string(string[startidx:])
-            # length == NaN: spec doesn't say; assume no substring to return
-            # length == -Inf: no substring to return
-            return datatypes.EMPTY_STRING
-
-        # length is finite, safe for int() and round().
-        length = int(round(length))
-
-        # return value must end before position (start+length)
-        # which is (start+length-1) in 0-based index
-        endidx = start + length - 1
-        if endidx < startidx:
-            return datatypes.EMPTY_STRING
-        return datatypes.string(string[startidx:endidx])
+        return datatypes.string(_xmlstring.substring(string, start, length))
     evaluate = evaluate_as_string
 
 
@@ -190,7 +157,7 @@ class normalize_space_function(builtin_function):
             string = datatypes.string(context.node)
         else:
             string = arg0.evaluate_as_string(context)
-        return datatypes.string(u' '.join(string.split()))
+        return datatypes.string(_xmlstring.normalizespace(string))
     evaluate = evaluate_as_string
 
 
@@ -205,15 +172,7 @@ class translate_function(builtin_function):
         source = arg0.evaluate_as_string(context)
         fromchars = arg1.evaluate_as_string(context)
         tochars = arg2.evaluate_as_string(context)
-        tochars = itertools.chain(tochars, itertools.repeat(u''))
- 
-        transmap = {}
-        for src, dst in itertools.izip(fromchars, tochars):
-            if src not in transmap:
-                transmap[src] = dst
-        chars = list(source)
-        for idx, ch in enumerate(chars):
-            if ch in transmap:
-                chars[idx] = transmap[ch]
-        return datatypes.string(u''.join(chars))
+        # the compiled (fromchars, tochars) table is cached by _xmlstring
+        return datatypes.string(_xmlstring.translate(source, fromchars,
+                                                     tochars))
     evaluate = evaluate_as_string
\ No newline at end of file
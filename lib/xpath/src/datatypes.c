@@ -1312,6 +1312,35 @@ static PyObject *NodeSet_New(Py_ssize_t size)
   return op;
 }
 
+/* Returns true if the items of `list` are children of the same parent and
+ * already in document order, as is the result of a single location step.
+ * That can be verified with one scan of the parent, whereas sorting would
+ * need to find the position of the siblings for every comparison. */
+static int nodeset_in_sibling_order(PyObject *list)
+{
+  PyObject **items = PySequence_Fast_ITEMS(list);
+  Py_ssize_t size = PyList_GET_SIZE(list);
+  NodeObject *parent, **nodes;
+  Py_ssize_t count, i, j;
+
+  if (size < 2 || !Node_Check(items[0]))
+    return 0;
+  parent = Node_GET_PARENT(items[0]);
+  if (parent == NULL)
+    return 0;
+  for (i = 1; i < size; i++) {
+    if (!Node_Check(items[i]) || Node_GET_PARENT(items[i]) != parent)
+      return 0;
+  }
+  nodes = Container_GET_NODES(parent);
+  count = Container_GET_COUNT(parent);
+  for (i = 0, j = 0; i < count && j < size; i++) {
+    if ((PyObject *)nodes[i] == items[j])
+      j++;
+  }
+  return j == size;
+}
+
 static PyObject *nodeset_new(PyTypeObject *type, PyObject *args,
                              PyObject *kwds)
 {
@@ -1337,7 +1366,7 @@ static PyObject *nodeset_new(PyTypeObject *type, PyObject *args,
   self = type->tp_alloc(type, 0);
   if (self != NULL) {
     if (PyList_Type.tp_init(self, args, kwds) < 0 ||
-        PyList_Sort(self) < 0) {
+        (!nodeset_in_sibling_order(self) && PyList_Sort(self) < 0)) {
       Py_DECREF(self);
       self = NULL;
     }
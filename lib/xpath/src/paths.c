@@ -185,6 +185,7 @@ static PyObject *stepiter_call(StepIterObject *self, PyObject *args,
   Py_XDECREF(self->current_nodes);
   self->current_nodes = NULL;
   Py_INCREF(context);
+  Py_XDECREF(self->context);
   self->context = context;
   Py_INCREF(self);
   return (PyObject *)self;
@@ -2,11 +2,22 @@
 # amara/xslt/expressions.py
 import operator
 
+from amara import tree
+
 class rtf_expression:
+    # Using `object` as a sentinel as `None` means "not text-only"
+    _missing = object()
+    _text_parts = _missing
+
     def __init__(self, instruction):
         self.instruction = instruction
 
     def evaluate(self, context):
+        parts = self._text_parts
+        if parts is self._missing:
+            parts = self._text_parts = _get_text_parts(self.instruction)
+        if parts is not None:
+            return self._evaluate_text(context, parts)
         context.push_tree_writer(self.instruction.baseUri)
         try:
             self.instruction.process_children(context)
@@ -14,6 +25,23 @@ class rtf_expression:
             writer = context.pop_writer()
         return writer.get_result()
 
+    def _evaluate_text(self, context, parts):
+        # The body can only produce text, so build the (at most one) text
+        # node directly instead of going through a tree writer.
+        data = []
+        for part in parts:
+            if isinstance(part, unicode):
+                data.append(part)
+            else:
+                context.instruction = part
+                context.namespaces = part.namespaces
+                data.append(part._select.evaluate_as_string(context))
+        data = u''.join(data)
+        rtf = tree.entity(self.instruction.baseUri)
+        if data:
+            rtf.xml_append(tree.text(data))
+        return rtf
+
     def pprint(self, indent=''):
         print indent + str(self)
 
@@ -21,10 +49,36 @@ class rtf_expression:
         return '<rtf_expression at %x: %s>' % (id(self), self.instruction)
 
 
+def _get_text_parts(instruction):
+    """
+    Returns the literal strings and `xsl:value-of` elements whose string
+    values make up the content of `instruction` if it consists only of
+    literal text, `xsl:text` and `xsl:value-of`, otherwise returns None.
+    """
+    from amara.xslt.tree import xslt_text
+    from amara.xslt.tree.text_element import text_element
+    from amara.xslt.tree.value_of_element import value_of_element
+    parts = []
+    for child in instruction.children:
+        if isinstance(child, xslt_text):
+            parts.append(child.data)
+        elif isinstance(child, text_element):
+            # unescaped text must be marked as such in the result tree
+            if child._disable_output_escaping:
+                return None
+            if child.children:
+                parts.append(child.children[0].data)
+        elif isinstance(child, value_of_element):
+            parts.append(child)
+        else:
+            return None
+    return parts
+
+
 class sorted_expression:
     def __init__(self, expression, keys):
         self.expression = expression
-        self.keys = tuple(reversed(keys or ()))
+        self.keys = tuple(keys or ())
         return
 
     def __str__(self):
@@ -36,25 +90,30 @@ class sorted_expression:
         else:
             nodes = self.expression.evaluate_as_nodeset(context)
 
-        # create initial sort structure
+        # compute the sort keys for every node, one column per `xsl:sort`
         initial_focus = context.node, context.position, context.size
         context.size = size = len(nodes)
-        decorated = [None]*size
+        columns = [ [None]*size for key in self.keys ]
         position = 0
         for node in nodes:
-            keys = decorated[position] = [node]
-            position += 1
             context.node = context.current_node = node
-            context.position = position
-            keys[1:] = [ key.get_key(context) for key in self.keys ]
+            context.position = position + 1
+            for key, column in zip(self.keys, columns):
+                column[position] = key.get_key(context)
+            position += 1
         context.node, context.position, context.size = initial_focus
 
-        # Now sort the nodes based on the `xsl:sort` parameters
-        index = 1
-        for key in self.keys:
-            compare, reverse = key.get_parameters(context)
-            decorated.sort(cmp=compare, key=operator.itemgetter(index),
-                           reverse=reverse)
-            index += 1
-        return map(operator.itemgetter(0), decorated)
+        # Map each column to values whose builtin ordering matches the
+        # `xsl:sort` parameters, then sort once on the composite key.  The
+        # sort is stable, so nodes with equal keys stay in document order.
+        for index, key in enumerate(self.keys):
+            collate = key.get_collation(context)
+            if collate is not None:
+                columns[index] = collate(columns[index])
+        if len(columns) == 1:
+            decorated = zip(columns[0], nodes)
+        else:
+            decorated = zip(zip(*columns), nodes)
+        decorated.sort(key=operator.itemgetter(0))
+        return map(operator.itemgetter(1), decorated)
     evaluate = evaluate_as_nodeset
@@ -3,10 +3,16 @@
 """
 EXSLT - Dates an Times (http://www.exslt.org/date/index.html)
 """
+from __future__ import absolute_import
+
 import re
+import math
+import time
 import calendar
+import warnings
 
 from amara.xpath import datatypes
+from amara.xslt.exslt._iso8601 import parse_datetime, parse_duration
 
 EXSL_DATE_TIME_NS = 'http://exslt.org/dates-and-times'
 
@@ -119,10 +125,7 @@ def month_name_function(context, date=None):
                                            'gMonthDay', 'gMonth'))
     except ValueError:
         return datatypes.EMPTY_STRING
-    return datatypes.string(
-        (u'', u'January', u'February', u'March', u'April', u'May', u'June',
-         u'July', u'August', u'September', u'October', u'November',
-         u'December')[datetime.month])
+    return datatypes.string(_MONTH_NAMES[datetime.month])
 
 
 def month_abbreviation_function(context, date=None):
@@ -137,9 +140,7 @@ def month_abbreviation_function(context, date=None):
                                            'gMonthDay', 'gMonth'))
     except ValueError:
         return datatypes.EMPTY_STRING
-    return datatypes.string(
-        (u'', u'Jan', u'Feb', u'Mar', u'Apr', u'May', u'Jun', u'Jul', u'Aug',
-         u'Sep', u'Oct', u'Nov', u'Dec')[datetime.month])
+    return datatypes.string(_MONTH_ABBREVIATIONS[datetime.month])
 
 
 def week_in_year_function(context, date=None):
@@ -149,37 +150,13 @@ def week_in_year_function(context, date=None):
 
     Implements version 3.
     """
-    # Notes:
-    #  - ISO 8601 specifies that Week 01 of the year is the week containing
-    #    the first Thursday;
     try:
         datetime = _coerce(context, date, ('dateTime', 'date'))
     except ValueError:
         return datatypes.NOT_A_NUMBER
 
-    year, month, day = datetime.year, datetime.month, datetime.day
-
-    # Find Jan 1 weekday for Y
-    # _dayOfWeek returns 0=Sun, we need Mon=0
-    day_of_week_0101 = (_day_of_week(year, 1, 1) + 6) % 7
-
-    # Find weekday for Y M D
-    day_number = _day_in_year(year, month, day)
-    day_of_week = (day_number + day_of_week_0101 - 1) % 7
-
-    # Find if Y M D falls in year Y-1, week 52 or 53
-    #  (i.e., the first 3 days of the year and DOW is Fri, Sat or Sun)
-    if day_of_week_0101 > 3 and day_number <= (7 - day_of_week_0101):
-        week = 52 + (day_of_week_0101 == (4 + _is_leap(year - 1)))
-    # Find if Y M D falls in Y+1, week 1
-    #  (i.e., the last 3 days of the year and DOW is Mon, Tue, or Wed)
-    elif (365 + _is_leap(year) - day_number) < (3 - day_of_week):
-        week = 1
-    else:
-        week = (day_number + (6 - day_of_week) + day_of_week_0101) / 7
-        if day_of_week_0101 > 3:
-            week -= 1
-    return datatypes.number(week)
+    return datatypes.number(_week_in_year(datetime.year, datetime.month,
+                                          datetime.day))
 
 
 def day_in_year_function(context, date=None):
@@ -224,9 +201,7 @@ def day_of_week_in_month_function(context, date=None):
         datetime = _coerce(context, date, ('dateTime', 'date'))
     except ValueError:
         return datatypes.NOT_A_NUMBER
-    # Note, using floor divison (//) to aid with `2to3` conversion
-    result = ((datetime.day - 1) // 7) + 1
-    return datatypes.number(result)
+    return datatypes.number(_day_of_week_in_month(datetime.day))
 
 
 def day_in_week_function(context, date=None):
@@ -257,9 +232,7 @@ def day_name_function(context, date=None):
     except ValueError:
         return datatypes.EMPTY_STRING
     weekday = _day_of_week(datetime.year, datetime.month, datetime.day)
-    weekday = (u'Sunday', u'Monday', u'Tuesday', u'Wednesday', u'Thursday',
-               u'Friday', u'Saturday')[weekday]
-    return datatypes.string(weekday)
+    return datatypes.string(_DAY_NAMES[weekday])
 
 
 def day_abbreviation_function(context, date=None):
@@ -274,8 +247,7 @@ def day_abbreviation_function(context, date=None):
     except ValueError:
         return datatypes.EMPTY_STRING
     weekday = _day_of_week(datetime.year, datetime.month, datetime.day)
-    weekday = (u'Sun', u'Mon', u'Tue', u'Wed', u'Thu', u'Fri', u'Sat')[weekday]
-    return datatypes.string(weekday)
+    return datatypes.string(_DAY_ABBREVIATIONS[weekday])
 
 
 def hour_in_day_function(context, time=None):
@@ -347,7 +319,7 @@ def format_date_function(context, datetime, pattern):
                                                'gMonthDay', 'gMonth', 'gDay'))
     except ValueError:
         return datatypes.EMPTY_STRING
-    pattern = pattern.evaluate_as_string(context)
+    pattern = _compile_format(pattern.evaluate_as_string(context))
 
     # Fill in missing components for right-truncated formats
     if datetime.year is not None:
@@ -361,120 +333,113 @@ def format_date_function(context, datetime, pattern):
         datetime.minute = 0
     if datetime.second is None:
         datetime.second = 0.0
-
-    def repl(match):
-        # NOTE: uses inherited `context` and `datetime` variables
-        groups = match.groupdict()
-        if groups['symbol'] is not None:
-            symbol = groups['symbol']
-            width = len(symbol)
-            symbol = symbol[:1]
-            if symbol == 'G':           # era designator
-                if dateTime.year is None:
-                    rt = u''
-                elif dateTime.year > 0:
-                    rt = u'AD'
-                else:
-                    rt = u'BC'
-            elif symbol == 'y':         # year
-                if dateTime.year is None:
-                    rt = u''
-                elif width > 2:
-                    rt = u'%0.*d' % (width, dateTime.year)
-                else:
-                    rt = u'%0.2d' % (dateTime.year % 100)
-            elif symbol == 'M':         # month in year
-                if dateTime.month is None:
-                    rt = u''
-                elif width >= 4:
-                    rt = MonthName(context, dateTime)
-                elif width == 3:
-                    rt = MonthAbbreviation(context, dateTime)
-                else:
-                    rt = u'%0.*d' % (width, dateTime.month)
-            elif symbol == 'd':         # day in month
-                if dateTime.day is None:
-                    rt = u''
-                else:
-                    rt = u'%0.*d' % (width, dateTime.day)
-            elif symbol == 'h':         # hour in am/pm (1-12)
-                hours = dateTime.hour
-                if hours > 12:
-                    hours -= 12
-                elif hours == 0:
-                    hours = 12
-                rt = u'%0.*d' % (width, hours)
-            elif symbol == 'H':         # hour in day (0-23)
-                rt = u'%0.*d' % (width, dateTime.hour)
-            elif symbol == 'm':         # minute in hour
-                rt = u'%0.*d' % (width, dateTime.minute)
-            elif symbol =='s':          # second in minute
-                rt = u'%0.*d' % (width, dateTime.second)
-            elif symbol == 'S':         # millisecond
-                fraction, second = math.modf(dateTime.second)
-                fraction, millisecond = math.modf(fraction * 10**width)
-                rt = u'%0.*d' % (width, millisecond + round(fraction))
-            elif symbol == 'E':         # day in week
-                if (dateTime.year is None or
-                    dateTime.month is None or
-                    dateTime.day is None):
-                    rt = u''
-                elif width >= 4:
-                    rt = DayName(context, dateTime)
-                else:
-                    rt = DayAbbreviation(context, dateTime)
-            elif symbol == 'D':         # day in year
-                if (dateTime.year is None or
-                    dateTime.month is None or
-                    dateTime.day is None):
-                    rt = u''
-                else:
-                    rt = u'%0.*d' % (width, DayInYear(context, dateTime))
-            elif symbol == 'F':         # day of week in month
-                if dateTime.day is None:
-                    rt = u''
-                else:
-                    day_of_week = DayOfWeekInMonth(context, dateTime)
-                    rt = u'%0.*d' % (width, day_of_week)
-            elif symbol == 'w':         # week in year
-                if (dateTime.year is None or
-                    dateTime.month is None or
-                    dateTime.day is None):
-                    rt = u''
-                else:
-                    rt = u'%0.*d' % (width, WeekInYear(context, dataTime))
-            elif symbol == 'W':         # week in month
-                if (dateTime.year is None or
-                    dateTime.month is None or
-                    dateTime.day is None):
-                    rt = u''
-                else:
-                    rt = u'%0.*d' % (width, WeekInMonth(context, dateTime))
-            elif symbol == 'a':
-                if dateTime.hour < 12:
-                    rt = u'AM'
+    have_date = not (datetime.year is None or datetime.month is None or
+                     datetime.day is None)
+
+    result = []
+    for part in pattern:
+        if part.__class__ is unicode:
+            result.append(part)
+            continue
+        symbol, width = part
+        if symbol == 'G':           # era designator
+            if datetime.year is None:
+                rt = u''
+            elif datetime.year > 0:
+                rt = u'AD'
+            else:
+                rt = u'BC'
+        elif symbol == 'y':         # year
+            if datetime.year is None:
+                rt = u''
+            elif width > 2:
+                rt = u'%0.*d' % (width, datetime.year)
+            else:
+                rt = u'%0.2d' % (datetime.year % 100)
+        elif symbol == 'M':         # month in year
+            if datetime.month is None:
+                rt = u''
+            elif width >= 4:
+                rt = _MONTH_NAMES[datetime.month]
+            elif width == 3:
+                rt = _MONTH_ABBREVIATIONS[datetime.month]
+            else:
+                rt = u'%0.*d' % (width, datetime.month)
+        elif symbol == 'd':         # day in month
+            if datetime.day is None:
+                rt = u''
+            else:
+                rt = u'%0.*d' % (width, datetime.day)
+        elif symbol == 'h':         # hour in am/pm (1-12)
+            hours = datetime.hour
+            if hours > 12:
+                hours -= 12
+            elif hours == 0:
+                hours = 12
+            rt = u'%0.*d' % (width, hours)
+        elif symbol == 'H':         # hour in day (0-23)
+            rt = u'%0.*d' % (width, datetime.hour)
+        elif symbol == 'm':         # minute in hour
+            rt = u'%0.*d' % (width, datetime.minute)
+        elif symbol =='s':          # second in minute
+            rt = u'%0.*d' % (width, datetime.second)
+        elif symbol == 'S':         # millisecond
+            fraction, second = math.modf(datetime.second)
+            fraction, millisecond = math.modf(fraction * 10**width)
+            rt = u'%0.*d' % (width, millisecond + round(fraction))
+        elif symbol == 'E':         # day in week
+            if not have_date:
+                rt = u''
+            else:
+                weekday = _day_of_week(datetime.year, datetime.month,
+                                       datetime.day)
+                if width >= 4:
+                    rt = _DAY_NAMES[weekday]
                 else:
-                    rt = u'PM'
-            elif symbol == 'k':         # hour in day (1-24)
-                rt = u'%0.*d' % (width, dateTime.hour + 1)
-            elif symbol == 'K':         # hour in am/pm (0-11)
-                hours = dateTime.hour
-                if hours >= 12:
-                    hours -= 12
-                rt = u'%0.*d' % (width, hours)
-            elif symbol == 'z':
-                rt = dateTime.timezone or u''
+                    rt = _DAY_ABBREVIATIONS[weekday]
+        elif symbol == 'D':         # day in year
+            if not have_date:
+                rt = u''
+            else:
+                rt = u'%0.*d' % (width, _day_in_year(datetime.year,
+                                                     datetime.month,
+                                                     datetime.day))
+        elif symbol == 'F':         # day of week in month
+            if datetime.day is None:
+                rt = u''
+            else:
+                rt = u'%0.*d' % (width, _day_of_week_in_month(datetime.day))
+        elif symbol == 'w':         # week in year
+            if not have_date:
+                rt = u''
             else:
-                # not reached due to regular expression (supposedly)
-                raise RuntimeException("bad format symbol '%s'" % symbol)
-        elif groups['escape']:
-            rt = groups['escape'].replace(u"''", u"'")
+                rt = u'%0.*d' % (width, _week_in_year(datetime.year,
+                                                      datetime.month,
+                                                      datetime.day))
+        elif symbol == 'W':         # week in month
+            if not have_date:
+                rt = u''
+            else:
+                rt = u'%0.*d' % (width, _week_in_month(datetime.year,
+                                                       datetime.month,
+                                                       datetime.day))
+        elif symbol == 'a':
+            if datetime.hour < 12:
+                rt = u'AM'
+            else:
+                rt = u'PM'
+        elif symbol == 'k':         # hour in day (1-24)
+            rt = u'%0.*d' % (width, datetime.hour + 1)
+        elif symbol == 'K':         # hour in am/pm (0-11)
+            hours = datetime.hour
+            if hours >= 12:
+                hours -= 12
+            rt = u'%0.*d' % (width, hours)
         else:
-            # 'escape' group was empty, just matched '' (escaped single quote)
-            rt = u"'"
-        return rt
-
-    return datatypes.string(_re_SimpleDateFormat.sub(repl, pattern))
+            assert symbol == 'z'
+            rt = datetime.timezone or u''
+        result.append(rt)
+    return datatypes.string(u''.join(result))
 
 
 def week_in_month_function(context, date=None):
@@ -489,14 +454,11 @@ def week_in_month_function(context, date=None):
     Implements version 3.
     """
     try:
-        dateTime = _coerce(dateTime, ('dateTime', 'date'))
+        datetime = _coerce(context, date, ('dateTime', 'date'))
     except ValueError:
-        return number.nan
-    day_of_week = _dayOfWeek(dateTime.year, dateTime.month, dateTime.day)
-    # _dayOfWeek returns 0=Sun, we need Sun=7
-    day_of_week = ((day_of_week + 6) % 7) + 1
-    week_offset = dateTime.day - day_of_week
-    return (week_offset / 7) + (week_offset % 7 and 2 or 1)
+        return datatypes.NOT_A_NUMBER
+    return datatypes.number(_week_in_month(datetime.year, datetime.month,
+                                           datetime.day))
 
 
 def difference_function(context, start, end):
@@ -507,11 +469,13 @@ def difference_function(context, start, end):
     Implements version 1.
     """
     try:
-        start = _coerce(start, ('dateTime', 'date', 'gYearMonth', 'gYear'))
-        end = _coerce(end, ('dateTime', 'date', 'gYearMonth', 'gYear'))
+        start = _coerce(context, start, ('dateTime', 'date', 'gYearMonth',
+                                         'gYear'))
+        end = _coerce(context, end, ('dateTime', 'date', 'gYearMonth',
+                                     'gYear'))
     except ValueError:
-        return u''
-    return unicode(_difference(start, end))
+        return datatypes.EMPTY_STRING
+    return datatypes.string(_difference(start, end))
 
 
 def add_function(context, date, duration):
@@ -521,11 +485,11 @@ def add_function(context, date, duration):
     Implements version 2.
     """
     try:
-        dateTime = _coerce(dateTime, ('dateTime', 'date', 'gYearMonth',
-                                      'gYear'))
-        duration = _Duration.parse(Conversions.StringValue(duration))
+        dateTime = _coerce(context, date, ('dateTime', 'date', 'gYearMonth',
+                                           'gYear'))
+        duration = _Duration.parse(duration.evaluate_as_string(context))
     except ValueError:
-        return u''
+        return datatypes.EMPTY_STRING
 
     result = _datetime()
     # Get the "adjusted" duration values
@@ -567,7 +531,7 @@ def add_function(context, date, duration):
     carry, result.hour = divmod(hours, 24)
 
     # Days
-    max_day = _daysInMonth(result.year, result.month)
+    max_day = _days_in_month(result.year, result.month)
     if dateTime.day > max_day:
         day = max_day
     if dateTime.day < 1:
@@ -576,15 +540,15 @@ def add_function(context, date, duration):
         day = dateTime.day
     result.day = day + days + carry
     while True:
-        max_day = _daysInMonth(result.year, result.month)
+        max_day = _days_in_month(result.year, result.month)
         if result.day > max_day:
             result.day -= max_day
             carry = 1
         elif result.day < 1:
             if result.month == 1:
-                max_day = _daysInMonth(result.year - 1, 12)
+                max_day = _days_in_month(result.year - 1, 12)
             else:
-                max_day = _daysInMonth(result.year, result.month - 1)
+                max_day = _days_in_month(result.year, result.month - 1)
             result.day += max_day
             carry = -1
         else:
@@ -611,7 +575,7 @@ def add_function(context, date, duration):
     # xs:dateTime
     else:
         result = unicode(result)
-    return result
+    return datatypes.string(result)
 
 
 def add_duration_function(context, duration1, duration2):
@@ -621,16 +585,15 @@ def add_duration_function(context, duration1, duration2):
 
     Implements version 2.
     """
-    duration1 = Conversions.StringValue(duration1)
-    duration2 = Conversions.StringValue(duration2)
+    duration1 = duration1.evaluate_as_string(context)
+    duration2 = duration2.evaluate_as_string(context)
     try:
         duration1 = _Duration.parse(duration1)
         duration2 = _Duration.parse(duration2)
-        duration = _addDurations(duration1, duration2)
+        duration = _add_durations(duration1, duration2)
     except ValueError:
-        return u''
-
-    return unicode(duration)
+        return datatypes.EMPTY_STRING
+    return datatypes.string(duration)
 
 
 def sum_function(context, nodeset):
@@ -641,16 +604,14 @@ def sum_function(context, nodeset):
 
     Implements version 1.
     """
-    if not isinstance(nodeset, XPathTypes.NodesetType):
-        return u''
+    nodeset = nodeset.evaluate_as_nodeset(context)
     try:
-        strings = map(Conversions.StringValue, nodeset)
+        strings = map(datatypes.string, nodeset)
         durations = map(_Duration.parse, strings)
-        duration = _addDurations(*durations)
+        duration = _add_durations(*durations)
     except ValueError:
-        return u''
-
-    return unicode(duration)
+        return datatypes.EMPTY_STRING
+    return datatypes.string(duration)
 
 
 def seconds_function(context, string=None):
@@ -662,9 +623,9 @@ def seconds_function(context, string=None):
     Implements version 1.
     """
     if string is None:
-        string = str(_datetime.now())
+        string = unicode(_datetime.now())
     else:
-        string = Conversions.StringValue(string)
+        string = string.evaluate_as_string(context)
 
     try:
         if 'P' in string:
@@ -676,18 +637,18 @@ def seconds_function(context, string=None):
                                                 'gYearMonth', 'gYear'))
             duration = _difference(_EPOCH, dateTime)
     except ValueError:
-        return number.nan
+        return datatypes.NOT_A_NUMBER
 
     # The number of years and months must both be equal to zero
     if duration.years or duration.months:
-        return number.nan
+        return datatypes.NOT_A_NUMBER
 
     # Convert the duration to just seconds
     seconds = (duration.days * 86400 + duration.hours * 3600 +
                duration.minutes * 60 + duration.seconds )
     if duration.negative:
         seconds *= -1
-    return seconds
+    return datatypes.number(seconds)
 
 
 def duration_function(context, seconds=None):
@@ -708,16 +669,23 @@ def duration_function(context, seconds=None):
         # Don't use fractional seconds to keep with constructed dateTimes
         seconds = int(time.time())
     else:
-        seconds = Conversions.NumberValue(seconds)
-        if not number.finite(seconds):
+        seconds = seconds.evaluate_as_number(context)
+        if not seconds.isfinite():
             # +/-Inf or NaN
-            return u''
+            return datatypes.EMPTY_STRING
     duration = _Duration(negative=(seconds < 0), seconds=abs(seconds))
-    return unicode(duration)
+    return datatypes.string(duration)
 
 
 ## Internals ##########################################################
 
+# Caches for the converted date/time and duration literals and the compiled
+# format-date patterns; they are simply emptied when full.
+_MAXCACHE = 1024
+_parsed_datetimes = {}
+_parsed_durations = {}
+_format_patterns = {}
+
 class _datetime(object):
     """
     INTERNAL: representation of an exact point on a timeline.
@@ -725,47 +693,27 @@ class _datetime(object):
 
     __slots__ = ('year', 'month', 'day', 'hour', 'minute', 'second', 'timezone')
 
-    patterns = {
-        'year'     : '[-]?[0-9]{4,}',
-        'month'    : '[0-9]{2}',
-        'day'      : '[0-9]{2}',
-        'hour'     : '[0-9]{2}',
-        'minute'   : '[0-9]{2}',
-        'second'   : '[0-9]{2}(?:[.][0-9]+)?',
-        'timezone' : 'Z|[-+][0-9]{2}:[0-9]{2}'
-        }
-    for name, pattern in patterns.iteritems():
-        patterns[name] = '(?P<%s>%s)' % (name, pattern)
-    del name, pattern
-
-    datatypes = {
-        'dateTime'   : '%(date)sT%(time)s',
-        'date'       : '%(year)s-%(month)s-%(day)s',
-        'time'       : '%(hour)s:%(minute)s:%(second)s',
-        'gYearMonth' : '%(year)s-%(month)s',
-        'gYear'      : '%(year)s',
-        'gMonthDay'  : '--%(month)s-%(day)s',
-        'gMonth'     : '--%(month)s',
-        'gDay'       : '---%(day)s',
-        }
-    datatypes['dateTime'] = datatypes['dateTime'] % datatypes
-    for name, pattern in datatypes.iteritems():
-        pattern = '^' + pattern + '%(timezone)s?$'
-        datatypes[name] = re.compile(pattern % patterns)
-    del name, pattern
+    # the lexical forms understood by `_iso8601.parse_datetime()`
+    datatypes = ('dateTime', 'date', 'time', 'gYearMonth', 'gYear',
+                 'gMonthDay', 'gMonth', 'gDay')
 
     def parse(cls, string, datatypes=None):
-        if not datatypes:
-            datatypes = cls.datatypes
-        for name in datatypes:
+        # Stylesheets tend to convert the same literals over and over, so
+        # the fields (or failure) of each conversion are remembered.
+        key = (string, datatypes or cls.datatypes)
+        try:
+            fields = _parsed_datetimes[key]
+        except KeyError:
+            if len(_parsed_datetimes) >= _MAXCACHE:
+                _parsed_datetimes.clear()
             try:
-                regexp = cls.datatypes[name]
-            except KeyError:
-                raise RuntimeException('unsupported datatype: %r' % name)
-            match = regexp.match(string)
-            if match:
-                return cls(**match.groupdict())
-        raise ValueError('invalid date/time literal: %r' % string)
+                fields = parse_datetime(*key)
+            except ValueError:
+                fields = None
+            _parsed_datetimes[key] = fields
+        if fields is None:
+            raise ValueError('invalid date/time literal: %r' % string)
+        return cls(*fields)
     parse = classmethod(parse)
 
     def now(cls):
@@ -831,29 +779,20 @@ class _Duration(object):
     __slots__ = ('negative', 'years', 'months', 'days', 'hours', 'minutes',
                  'seconds')
 
-    regexp = re.compile('^(?P<negative>[-])?P(?:(?P<years>[0-9]+)Y)?'
-                        '(?:(?P<months>[0-9]+)M)?(?:(?P<days>[0-9]+)D)?'
-                        '(?P<time>T(?:(?P<hours>[0-9]+)H)?'
-                        '(?:(?P<minutes>[0-9]+)M)?'
-                        '(?:(?P<seconds>[0-9]+(?:[.][0-9]+)?)S)?)?$')
-
     def parse(cls, string):
-        match = cls.regexp.match(string)
-        if match:
-            parts = match.groupdict()
-            # Verify that if the time designator is given, there is at least
-            # one time component as well.  This cannot be done easily with
-            # just the RE.
-            time = parts['time']
+        try:
+            fields = _parsed_durations[string]
+        except KeyError:
+            if len(_parsed_durations) >= _MAXCACHE:
+                _parsed_durations.clear()
             try:
-                time is None or time[1]
-            except IndexError:
-                # Fall through to the ValueError below
-                pass
-            else:
-                del parts['time']
-                return cls(**parts)
-        raise ValueError('invalid duration literal: %r' % string)
+                fields = parse_duration(string)
+            except ValueError:
+                fields = None
+            _parsed_durations[string] = fields
+        if fields is None:
+            raise ValueError('invalid duration literal: %r' % string)
+        return cls(*fields)
     parse = classmethod(parse)
 
     def __init__(self, negative=None, years=None, months=None, days=None,
@@ -904,18 +843,67 @@ class _Duration(object):
         return ''.join(parts)
 
 
-def _coerce(obj, datatypes):
+def _coerce(context, obj, datatypes):
     """
-    INTERNAL: converts an XPath object to a `_datetime` instance.
+    INTERNAL: converts an XPath expression to a `_datetime` instance.
     """
     if obj is None:
-        obj = _datetime.now()
-    elif not isinstance(obj, _datetime):
-        obj = _datetime.parse(Conversions.StringValue(obj), datatypes)
-    return obj
+        return _datetime.now()
+    return _datetime.parse(obj.evaluate_as_string(context), datatypes)
+
+
+_is_leap = calendar.isleap
+
+_MONTH_NAMES = (u'', u'January', u'February', u'March', u'April', u'May',
+                u'June', u'July', u'August', u'September', u'October',
+                u'November', u'December')
+_MONTH_ABBREVIATIONS = (u'', u'Jan', u'Feb', u'Mar', u'Apr', u'May', u'Jun',
+                        u'Jul', u'Aug', u'Sep', u'Oct', u'Nov', u'Dec')
+_DAY_NAMES = (u'Sunday', u'Monday', u'Tuesday', u'Wednesday', u'Thursday',
+              u'Friday', u'Saturday')
+_DAY_ABBREVIATIONS = (u'Sun', u'Mon', u'Tue', u'Wed', u'Thu', u'Fri', u'Sat')
+
+def _compile_format(pattern):
+    """
+    INTERNAL: splits a SimpleDateFormat pattern into a list of literal
+    strings and (symbol, width) tuples.
+    """
+    try:
+        return _format_patterns[pattern]
+    except KeyError:
+        pass
+    parts = []
+    last = 0
+    for match in _re_SimpleDateFormat.finditer(pattern):
+        start = match.start()
+        if start > last:
+            parts.append(pattern[last:start])
+        last = match.end()
+        symbol, escape = match.group('symbol', 'escape')
+        if symbol is not None:
+            parts.append((symbol[:1], len(symbol)))
+        elif escape:
+            parts.append(escape.replace(u"''", u"'"))
+        else:
+            # 'escape' group was empty, just matched '' (escaped single quote)
+            parts.append(u"'")
+    if last < len(pattern):
+        parts.append(pattern[last:])
+    # merge adjacent literals
+    compiled = []
+    for part in parts:
+        if compiled and part.__class__ is unicode and \
+           compiled[-1].__class__ is unicode:
+            compiled[-1] += part
+        else:
+            compiled.append(part)
+    if len(_format_patterns) >= _MAXCACHE:
+        _format_patterns.clear()
+    _format_patterns[pattern] = compiled
+    return compiled
 
 
-def _daysInMonth(year, month):
+def _days_in_month(year, month):
     """
     INTERNAL: calculates the number of days in a month for the given date.
     """
@@ -925,7 +913,7 @@ def _daysInMonth(year, month):
     return days
 
 
-def _dayInYear(year, month, day):
+def _day_in_year(year, month, day):
     """
     INTERNAL: calculates the ordinal date for the given date.
     """
@@ -935,20 +923,71 @@ def _dayInYear(year, month, day):
     return days + day
 
 
-def _julianDay(year, month, day):
+def _julian_day(year, month, day):
     """
     INTERNAL: calculates the Julian day (1-1-1 is day 1) for the given date.
     """
-    date = _dayInYear(year, month, day)
+    date = _day_in_year(year, month, day)
     year -= 1
     return year*365 + (year / 4) - (year / 100) + (year / 400) + date
 
 
-def _dayOfWeek(year, month, day):
+def _day_of_week(year, month, day):
     """
     INTERNAL: calculates the day of week (0=Sun, 6=Sat) for the given date.
     """
-    return _julianDay(year, month, day) % 7
+    return _julian_day(year, month, day) % 7
+
+
+def _day_of_week_in_month(day):
+    """
+    INTERNAL: calculates the day-of-the-week in a month for the given day
+    (e.g., 3 for the 3rd Tuesday).
+    """
+    # Note, using floor divison (//) to aid with `2to3` conversion
+    return ((day - 1) // 7) + 1
+
+
+def _week_in_year(year, month, day):
+    """
+    INTERNAL: calculates the ISO 8601 week number for the given date.
+    """
+    # Notes:
+    #  - ISO 8601 specifies that Week 01 of the year is the week containing
+    #    the first Thursday;
+    # Find Jan 1 weekday for Y
+    # _day_of_week returns 0=Sun, we need Mon=0
+    day_of_week_0101 = (_day_of_week(year, 1, 1) + 6) % 7
+
+    # Find weekday for Y M D
+    day_number = _day_in_year(year, month, day)
+    day_of_week = (day_number + day_of_week_0101 - 1) % 7
+
+    # Find if Y M D falls in year Y-1, week 52 or 53
+    #  (i.e., the first 3 days of the year and DOW is Fri, Sat or Sun)
+    if day_of_week_0101 > 3 and day_number <= (7 - day_of_week_0101):
+        week = 52 + (day_of_week_0101 == (4 + _is_leap(year - 1)))
+    # Find if Y M D falls in Y+1, week 1
+    #  (i.e., the last 3 days of the year and DOW is Mon, Tue, or Wed)
+    elif (365 + _is_leap(year) - day_number) < (3 - day_of_week):
+        week = 1
+    else:
+        week = (day_number + (6 - day_of_week) + day_of_week_0101) / 7
+        if day_of_week_0101 > 3:
+            week -= 1
+    return week
+
+
+def _week_in_month(year, month, day):
+    """
+    INTERNAL: calculates the week in the month for the given date, where
+    weeks begin on a Monday.
+    """
+    day_of_week = _day_of_week(year, month, day)
+    # _day_of_week returns 0=Sun, we need Sun=7
+    day_of_week = ((day_of_week + 6) % 7) + 1
+    week_offset = day - day_of_week
+    return (week_offset / 7) + (week_offset % 7 and 2 or 1)
 
 
 def _difference(start, end):
@@ -973,8 +1012,8 @@ def _difference(start, end):
         negative = negative or (start.month > end.month)
         return _Duration(negative=negative, years=years, months=months)
 
-    start_days = _julianDay(start.year, start.month, start.day)
-    end_days = _julianDay(end.year, end.month, end.day)
+    start_days = _julian_day(start.year, start.month, start.day)
+    end_days = _julian_day(end.year, end.month, end.day)
     days = end_days - start_days
     negative = start_days > end_days
 
@@ -999,7 +1038,7 @@ def _difference(start, end):
                      minutes=minutes, seconds=seconds)
 
 
-def _addDurations(*durations):
+def _add_durations(*durations):
     """
     INTERNAL: returns a new duration from the sum of the sequence of durations
     """
@@ -5,10 +5,33 @@ EXSLT 2.0 - Regular Expressions (http://www.exslt.org/regexp/index.html)
 """
 import re
 
+from amara import tree
 from amara.xpath import datatypes
 
 EXSL_REGEXP_NS = "http://exslt.org/regular-expressions"
 
+# Compiled patterns, keyed by pattern and flags.  Like the cache in the `re`
+# module, it is simply emptied once it grows past its limit.
+_MAXCACHE = 256
+_cache = {}
+
+def _compile(pattern, flags):
+    key = (pattern, 'i' in flags)
+    try:
+        return _cache[key]
+    except KeyError:
+        if len(_cache) >= _MAXCACHE:
+            _cache.clear()
+        regexp = _cache[key] = re.compile(pattern,
+                                          re.IGNORECASE if key[1] else 0)
+        return regexp
+
+def _match_element(text):
+    element = tree.element(None, u'match')
+    if text:
+        element.xml_append(tree.text(text))
+    return element
+
 def match_function(context, source, pattern, flags=None):
     """
     The regexp:match function lets you get hold of the substrings of the
@@ -39,31 +62,26 @@ def match_function(context, source, pattern, flags=None):
     pattern = pattern.evaluate_as_string(context)
     flags = flags.evaluate_as_string(context) if flags else ''
 
-    regexp = re.compile(pattern, re.IGNORECASE if 'i' in flags else 0)
+    regexp = _compile(pattern, flags)
 
     match = regexp.search(source)
     if match is None:
         return datatypes.nodeset()
-    context.push_tree_writer(context.instruction.baseUri)
     if 'g' in flags:
         # find all matches in the source
+        matches = []
         while match:
-            context.start_element(u'match')
             # return everything that matched the pattern
-            context.text(match.group())
-            context.end_element(u'match')
+            matches.append(_match_element(match.group()))
             match = regexp.search(source, match.end())
     else:
         # the first 'match' element contains entire matched text
-        all = [match.group()]
-        groups = match.groups()
-        groups and all.extend(list(groups))
-        for match in all:
-            context.start_element(u'match')
-            match and context.text(match)
-            context.end_element(u'match')
-    writer = context.pop_writer()
-    rtf = writer.get_result()
+        matches = [_match_element(match.group())]
+        matches.extend(map(_match_element, match.groups()))
+    # The elements are created directly into the result tree fragment, there
+    # is no need for the overhead of a tree writer.
+    rtf = tree.entity(context.instruction.baseUri)
+    rtf.xml_splice(0, 0, matches)
     return datatypes.nodeset(rtf.xml_children)
 
 
@@ -93,7 +111,7 @@ def replace_function(context, source, pattern, flags, repl):
     flags = flags.evaluate_as_string(context)
     repl = repl.evaluate_as_string(context)
 
-    regexp = re.compile(pattern, re.IGNORECASE if 'i' in flags else 0)
+    regexp = _compile(pattern, flags)
     # a count of zero means replace all in RE.sub()
     result = regexp.sub(repl, source, 'g' not in flags)
     return datatypes.string(result)
@@ -119,7 +137,7 @@ def test_function(context, source, pattern, flags=''):
     pattern = pattern.evaluate_as_string(context)
     flags = flags.evaluate_as_string(context) if flags else ''
 
-    regexp = re.compile(pattern, re.IGNORECASE if 'i' in flags else 0)
+    regexp = _compile(pattern, flags)
     return datatypes.TRUE if regexp.search(source) else datatypes.FALSE
 
 
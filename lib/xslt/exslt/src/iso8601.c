@@ -0,0 +1,346 @@
+/***********************************************************************
+ * amara/xslt/exslt/src/iso8601.c
+ ***********************************************************************/
+
+static char module_doc[] = "\
+Lexical scanners for the XML Schema date/time and duration datatypes\n\
+";
+
+#include "Python.h"
+
+#define MODULE_NAME "amara.xslt.exslt._iso8601"
+#define MODULE_INITFUNC init_iso8601
+
+/* The lexical forms of the supported datatypes.  Each template character
+ * matches a field, everything else must match literally:
+ *   Y - year ('-'? [0-9]{4,})
+ *   M - month, D - day, h - hour, m - minute ([0-9]{2})
+ *   s - second ([0-9]{2} ('.' [0-9]+)?)
+ * Every form may be followed by a timezone ('Z' | [-+] [0-9]{2} ':' [0-9]{2}).
+ */
+static const struct {
+  const char *name;
+  const char *template;
+} lexical_forms[] = {
+  { "dateTime",   "Y-M-DTh:m:s" },
+  { "date",       "Y-M-D" },
+  { "time",       "h:m:s" },
+  { "gYearMonth", "Y-M" },
+  { "gYear",      "Y" },
+  { "gMonthDay",  "--M-D" },
+  { "gMonth",     "--M" },
+  { "gDay",       "---D" },
+  { NULL, NULL }
+};
+
+#define IS_DIGIT(c) ((c) >= '0' && (c) <= '9')
+#define DIGIT_VALUE(c) ((int)((c) - '0'))
+
+/* The regular expressions used previously anchored the match with `$`,
+ * which also accepts a single trailing newline. */
+#define AT_END(p, end) ((p) == (end) || ((p) + 1 == (end) && *(p) == '\n'))
+
+enum { FIELD_YEAR, FIELD_MONTH, FIELD_DAY, FIELD_HOUR, FIELD_MINUTE,
+       FIELD_SECOND, FIELD_TIMEZONE, NUM_FIELDS };
+
+typedef struct {
+  const Py_UNICODE *start;
+  Py_ssize_t size;
+} Span;
+
+/** Private Routines **************************************************/
+
+static const Py_UNICODE *scan_digits(const Py_UNICODE *p,
+                                     const Py_UNICODE *end)
+{
+  while (p < end && IS_DIGIT(*p))
+    p++;
+  return p;
+}
+
+/* Returns the position following the match of `template`, or NULL */
+static const Py_UNICODE *scan_lexical_form(const char *template,
+                                           const Py_UNICODE *p,
+                                           const Py_UNICODE *end,
+                                           Span fields[NUM_FIELDS])
+{
+  const Py_UNICODE *start;
+  int field;
+
+  for (; *template; template++) {
+    start = p;
+    switch (*template) {
+    case 'Y':
+      if (p < end && *p == '-')
+        p++;
+      p = scan_digits(p, end);
+      if (p - start < 4 || (p - start == 4 && *start == '-'))
+        return NULL;
+      field = FIELD_YEAR;
+      break;
+    case 'M': field = FIELD_MONTH; goto two_digits;
+    case 'D': field = FIELD_DAY; goto two_digits;
+    case 'h': field = FIELD_HOUR; goto two_digits;
+    case 'm': field = FIELD_MINUTE; goto two_digits;
+    case 's':
+      field = FIELD_SECOND;
+      if (end - p < 2 || !IS_DIGIT(p[0]) || !IS_DIGIT(p[1]))
+        return NULL;
+      p += 2;
+      if (end - p >= 2 && p[0] == '.' && IS_DIGIT(p[1]))
+        p = scan_digits(p + 1, end);
+      break;
+    two_digits:
+      if (end - p < 2 || !IS_DIGIT(p[0]) || !IS_DIGIT(p[1]))
+        return NULL;
+      p += 2;
+      break;
+    default:
+      if (p == end || *p != (Py_UNICODE)*template)
+        return NULL;
+      p++;
+      continue;
+    }
+    fields[field].start = start;
+    fields[field].size = p - start;
+  }
+
+  /* optional timezone */
+  start = p;
+  if (p < end && *p == 'Z') {
+    p++;
+  } else if (end - p >= 6 && (p[0] == '-' || p[0] == '+') &&
+             IS_DIGIT(p[1]) && IS_DIGIT(p[2]) && p[3] == ':' &&
+             IS_DIGIT(p[4]) && IS_DIGIT(p[5])) {
+    p += 6;
+  }
+  fields[FIELD_TIMEZONE].start = start;
+  fields[FIELD_TIMEZONE].size = p - start;
+  return AT_END(p, end) ? p : NULL;
+}
+
+static PyObject *two_digit_value(Span *span)
+{
+  return PyInt_FromLong(DIGIT_VALUE(span->start[0]) * 10 +
+                        DIGIT_VALUE(span->start[1]));
+}
+
+static PyObject *float_value(const Py_UNICODE *start, Py_ssize_t size)
+{
+  PyObject *str, *result;
+
+  str = PyUnicode_FromUnicode(start, size);
+  if (str == NULL)
+    return NULL;
+  result = PyFloat_FromString(str, NULL);
+  Py_DECREF(str);
+  return result;
+}
+
+static PyObject *invalid_literal(const char *what, PyObject *string)
+{
+  PyObject *repr = PyObject_Repr(string);
+  if (repr) {
+    PyErr_Format(PyExc_ValueError, "invalid %s literal: %s", what,
+                 PyString_AS_STRING(repr));
+    Py_DECREF(repr);
+  }
+  return NULL;
+}
+
+/** Public Methods ****************************************************/
+
+static char parse_datetime_doc[] =
+"parse_datetime(string, datatypes) -> tuple\n\
+\n\
+Match `string` against the lexical forms named in the sequence `datatypes`\n\
+(e.g., 'dateTime', 'gYear'), in order.  Returns the tuple (year, month, day,\n\
+hour, minute, second, timezone) for the first matching form, with None for\n\
+the fields the form does not include.  Raises ValueError if no form matches.";
+
+static PyObject *parse_datetime(PyObject *self, PyObject *args)
+{
+  PyObject *string, *datatypes, *result = NULL;
+  const Py_UNICODE *p, *end;
+  Span fields[NUM_FIELDS];
+  Py_ssize_t i, size;
+  int field;
+
+  if (!PyArg_ParseTuple(args, "OO:parse_datetime", &string, &datatypes))
+    return NULL;
+
+  string = PyUnicode_FromObject(string);
+  if (string == NULL)
+    return NULL;
+  datatypes = PySequence_Fast(datatypes, "datatypes must be a sequence");
+  if (datatypes == NULL) {
+    Py_DECREF(string);
+    return NULL;
+  }
+  p = PyUnicode_AS_UNICODE(string);
+  end = p + PyUnicode_GET_SIZE(string);
+
+  size = PySequence_Fast_GET_SIZE(datatypes);
+  for (i = 0; i < size; i++) {
+    PyObject *name = PySequence_Fast_GET_ITEM(datatypes, i);
+    const char *chars = PyString_AsString(name);
+    int form;
+    if (chars == NULL)
+      goto finally;
+    for (form = 0; lexical_forms[form].name; form++) {
+      if (strcmp(chars, lexical_forms[form].name) == 0)
+        break;
+    }
+    if (lexical_forms[form].name == NULL) {
+      PyErr_Format(PyExc_KeyError, "unsupported datatype: '%s'", chars);
+      goto finally;
+    }
+    memset(fields, 0, sizeof(fields));
+    if (scan_lexical_form(lexical_forms[form].template, p, end, fields))
+      break;
+  }
+  if (i == size) {
+    invalid_literal("date/time", string);
+    goto finally;
+  }
+
+  result = PyTuple_New(NUM_FIELDS);
+  if (result == NULL)
+    goto finally;
+  for (field = 0; field < NUM_FIELDS; field++) {
+    Span *span = &fields[field];
+    PyObject *value;
+    if (span->size == 0) {
+      Py_INCREF(Py_None);
+      value = Py_None;
+    } else if (field == FIELD_YEAR) {
+      value = PyInt_FromUnicode((Py_UNICODE *)span->start, span->size, 10);
+    } else if (field == FIELD_SECOND) {
+      value = float_value(span->start, span->size);
+    } else if (field == FIELD_TIMEZONE) {
+      value = PyUnicode_FromUnicode(span->start, span->size);
+    } else {
+      value = two_digit_value(span);
+    }
+    if (value == NULL) {
+      Py_CLEAR(result);
+      goto finally;
+    }
+    PyTuple_SET_ITEM(result, field, value);
+  }
+
+finally:
+  Py_DECREF(datatypes);
+  Py_DECREF(string);
+  return result;
+}
+
+static char parse_duration_doc[] =
+"parse_duration(string) -> tuple\n\
+\n\
+Scan `string` as an xs:duration.  Returns the tuple (negative, years,\n\
+months, days, hours, minutes, seconds), with 0 for the omitted components.\n\
+Raises ValueError if `string` is not a valid duration.";
+
+static PyObject *parse_duration(PyObject *self, PyObject *args)
+{
+  static const char designators[] = "YMDHMS";
+  PyObject *string, *result;
+  const Py_UNICODE *p, *end, *start;
+  Span components[6];
+  int negative, time, index, next;
+
+  if (!PyArg_ParseTuple(args, "O:parse_duration", &string))
+    return NULL;
+
+  string = PyUnicode_FromObject(string);
+  if (string == NULL)
+    return NULL;
+  p = PyUnicode_AS_UNICODE(string);
+  end = p + PyUnicode_GET_SIZE(string);
+  memset(components, 0, sizeof(components));
+
+  negative = (p < end && *p == '-');
+  if (negative)
+    p++;
+  if (p == end || *p++ != 'P')
+    goto invalid;
+
+  /* date components are designated by YMD, time components (following
+   * the 'T') by HMS; each may appear at most once and in that order */
+  for (next = 0, time = 0; !AT_END(p, end); ) {
+    if (*p == 'T') {
+      if (time)
+        goto invalid;
+      p++;
+      next = 3;
+      time = 1;
+      /* at least one time component must follow the designator */
+      if (p == end || !IS_DIGIT(*p))
+        goto invalid;
+      continue;
+    }
+    start = p;
+    p = scan_digits(p, end);
+    if (p == start || p == end)
+      goto invalid;
+    if (*p == '.' && time) {
+      /* only the seconds may have a fraction */
+      const Py_UNICODE *fraction = ++p;
+      p = scan_digits(p, end);
+      if (p == fraction || p == end || *p != 'S')
+        goto invalid;
+    }
+    for (index = next; index < 6; index++) {
+      if (*p == (Py_UNICODE)designators[index])
+        break;
+    }
+    if (index == 6 || (index >= 3) != time)
+      goto invalid;
+    components[index].start = start;
+    components[index].size = p - start;
+    next = index + 1;
+    p++;
+  }
+  if (!AT_END(p, end))
+    goto invalid;
+
+  result = PyTuple_New(7);
+  if (result == NULL)
+    goto error;
+  PyTuple_SET_ITEM(result, 0, PyBool_FromLong(negative));
+  for (index = 0; index < 6; index++) {
+    Span *span = &components[index];
+    PyObject *value;
+    if (span->size == 0)
+      value = PyInt_FromLong(0);
+    else if (index == 5)
+      value = float_value(span->start, span->size);
+    else
+      value = PyInt_FromUnicode((Py_UNICODE *)span->start, span->size, 10);
+    if (value == NULL) {
+      Py_DECREF(result);
+      goto error;
+    }
+    PyTuple_SET_ITEM(result, index + 1, value);
+  }
+  Py_DECREF(string);
+  return result;
+
+invalid:
+  invalid_literal("duration", string);
+error:
+  Py_DECREF(string);
+  return NULL;
+}
+
+static PyMethodDef module_methods[] = {
+  { "parse_datetime", parse_datetime, METH_VARARGS, parse_datetime_doc },
+  { "parse_duration", parse_duration, METH_VARARGS, parse_duration_doc },
+  { NULL }
+};
+
+PyMODINIT_FUNC MODULE_INITFUNC(void)
+{
+  Py_InitModule3(MODULE_NAME, module_methods, module_doc);
+}
@@ -55,6 +55,7 @@ class document_function(builtin_function):
 
         documents = context.documents
         sources = context.transform.root.sources
+        cache = getattr(context.processor, 'document_cache', None)
         result = []
         for uri in uris:
             if uri in documents:
@@ -62,6 +63,8 @@ class document_function(builtin_function):
             else:
                 if uri in sources:
                     doc = amara.parse(StringIO(sources[uri]), uri)
+                elif cache is not None:
+                    doc = cache.fetch(uri)
                 else:
                     doc = amara.parse(uri)
                 documents[uri] = doc
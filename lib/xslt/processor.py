@@ -3,13 +3,15 @@
 """
 XSLT processing engine
 """
-import os, sys, operator, cStringIO, warnings
+import os, sys, operator, cStringIO, warnings, threading
 from gettext import gettext as _
 
 DEFAULT_ENCODING = 'UTF-8'
 #from amara import DEFAULT_ENCODING
+import amara
 from amara import ReaderError, tree
 from amara.lib import iri, inputsource
+from amara.lib.irihelpers import uridict
 from amara.xpath import XPathError
 from amara.xslt import XsltError
 from amara.xslt import xsltcontext
@@ -35,6 +37,85 @@ XSLT_IMT = ['application/xslt+xml', 'application/xslt',
 # for xsl:message output
 MESSAGE_TEMPLATE = _('STYLESHEET MESSAGE:\n%s\nEND STYLESHEET MESSAGE\n')
 
+
+class document_cache(object):
+    """
+    A size-bounded cache of the documents loaded by the XSLT document()
+    function.  Unlike the documents of a single run, which are discarded
+    with its context, the parsed trees are shared by every run of the
+    processors given the cache, so lookup documents used by the same
+    stylesheet over and over are only parsed once.
+
+    Entries are keyed by absolute URI.  For file: URIs, the modification
+    time and size of the file are recorded as well, and a changed file is
+    parsed again.  Other resources are assumed not to change for the
+    lifetime of the entry.  When the cache is full, the least recently
+    used entries are discarded.
+
+    The cached trees are shared, so they must be treated as read-only.  A
+    single instance can be shared by processors in several threads.
+    """
+    def __init__(self, max_entries=64):
+        self.max_entries = max_entries
+        self._entries = uridict()
+        self._tick = 0
+        self._lock = threading.Lock()
+        return
+
+    def __len__(self):
+        return len(self._entries)
+
+    def __contains__(self, uri):
+        return uri in self._entries
+
+    def _validator(self, uri):
+        if uri[:5].lower() != 'file:':
+            return None
+        try:
+            info = os.stat(iri.uri_to_os_path(uri))
+        except (OSError, iri.IriError):
+            return None
+        return (info.st_mtime, info.st_size)
+
+    def fetch(self, uri):
+        """
+        Return the document for the URI, parsing it if it is not cached or
+        has changed since it was cached
+        """
+        validator = self._validator(uri)
+        self._lock.acquire()
+        try:
+            entry = self._entries.get(uri)
+            if entry is not None and entry[1] == validator:
+                self._tick += 1
+                entry[0] = self._tick
+                return entry[2]
+        finally:
+            self._lock.release()
+
+        document = amara.parse(uri)
+
+        self._lock.acquire()
+        try:
+            self._tick += 1
+            self._entries[uri] = [self._tick, validator, document]
+            if len(self._entries) > self.max_entries:
+                entries = dict.items(self._entries)
+                entries.sort(key=lambda item: item[1][0])
+                for key, entry in entries[:-self.max_entries or None]:
+                    dict.__delitem__(self._entries, key)
+        finally:
+            self._lock.release()
+        return document
+
+    def clear(self):
+        self._lock.acquire()
+        try:
+            self._entries.clear()
+        finally:
+            self._lock.release()
+        return
+
 class processor(object):
     """
     An XSLT processing engine (4XSLT).
@@ -76,6 +157,10 @@ class processor(object):
 
       .transform: the complete transformation tree.
 
+      .document_cache: a document_cache used to share the documents loaded
+        by the document() function between runs, or None (the default)
+        to load them afresh for every run.
+
     """
     # defaults for ExtendedProcessingElements.ExtendedProcessor
     _4xslt_debug = False
@@ -89,7 +174,8 @@ class processor(object):
 
     def __init__(self, ignore_pis=False, content_types=None,
                  media_descriptors=None, extension_parameters=None,
-                 message_stream=None, message_template=None):
+                 message_stream=None, message_template=None,
+                 document_cache=None):
         self.ignore_pis = ignore_pis
         if content_types is None:
             content_types = set(XSLT_IMT)
@@ -108,6 +194,7 @@ class processor(object):
         if message_template is None:
             message_template = MESSAGE_TEMPLATE
         self.message_template = message_template
+        self.document_cache = document_cache
         self.transform = None
 
         self._extfunctions = {}  #Cache ext functions to give to the context
@@ -506,18 +593,29 @@ class processor(object):
         #  This method is use-at-your-own-risk. The XSLT conformance of the
         #  source is maintained by the caller. This exists as a performance
         #  hook.
-        parameters = parameters or {}
-
-        self.attributeSets = {}
-        self.keys = {}
-
-        #See f:chain-to extension element
-        self.chainTo = None
-        self.chainParams = None
-
         if not self.transform:
             raise XsltError(XsltError.NO_STYLESHEET)
+        return self._execute(node, self._filter_parameters(parameters), result)
 
+    def prepare(self, parameters=None):
+        """
+        Returns a `prepared_transform` for running the registered
+        stylesheets with the given stylesheet parameters against many
+        source documents.
+        """
+        return prepared_transform(self, parameters)
+
+    def _filter_parameters(self, parameters):
+        # Only those parameters declared by the stylesheet are bound
+        initial_variables = {}
+        if parameters:
+            declared = self.transform.parameters
+            for name in parameters:
+                if name in declared:
+                    initial_variables[name] = parameters[name]
+        return initial_variables
+
+    def _execute(self, node, variables, result):
         # Use an internal result to gather the output only if the caller
         # didn't supply other means of retrieving it.
         if result is None:
@@ -525,22 +623,30 @@ class processor(object):
         result.parameters = self.transform.output_parameters
         assert result.writer
 
-        # Initialize any stylesheet parameters
-        initial_variables = parameters.copy()
-        for name in parameters:
-            if name not in self.transform.parameters:
-                del initial_variables[name]
-
-        # Prepare the stylesheet for processing
         context = xsltcontext.xsltcontext(node,
-                                          variables=initial_variables,
+                                          variables=variables,
                                           transform=self.transform,
                                           processor=self,
                                           extfunctions=self._extfunctions,
                                           output_parameters=result.parameters)
+        return self._process(context, result)
+
+    def _process(self, context, result, prepared=None):
+        self.attributeSets = {}
+        self.keys = {}
+
+        #See f:chain-to extension element
+        self.chainTo = None
+        self.chainParams = None
+
+        # Prepare the stylesheet for processing
+        node = context.node
         context.add_document(node, node.xml_base)
         context.push_writer(result.writer)
-        self.transform.root.prime(context)
+        if prepared is None:
+            self.transform.root.prime(context)
+        else:
+            prepared.prime(context)
 
         # Process the document
         try:
@@ -728,3 +834,77 @@ class processor(object):
         self.stylesheet = None
         self.getStylesheetReader().reset()
         return
+
+
+class prepared_transform(object):
+    """
+    The stylesheets of a processor readied for running against many source
+    documents with the same stylesheet parameters (see `processor.prepare()`).
+
+    The work which does not depend upon the source document is done just
+    once, instead of for every run: the parameters are filtered, the
+    top-level variables and parameters with literal values are evaluated,
+    the instructions other than the top-level variables are primed (named
+    template lookups, extension functions), and a context holding the
+    results is set up for the runs to start from.  Processing instructions
+    in the source documents (xml-stylesheet) are not considered.
+
+    The stylesheets must not be changed while the instance is in use.
+    """
+    def __init__(self, processor, parameters=None):
+        if not processor.transform:
+            raise XsltError(XsltError.NO_STYLESHEET)
+        self.processor = processor
+        transform = self._transform = processor.transform
+        self._output_parameters = transform.output_parameters
+        context = xsltcontext.xsltcontext(tree.entity(),
+            variables=processor._filter_parameters(parameters),
+            transform=transform,
+            processor=processor,
+            extfunctions=processor._extfunctions)
+        for instruction in transform.root.prime_instructions:
+            if instruction is not transform:
+                instruction.prime(context)
+        transform.prime_constants(context)
+        self._context = context
+        # The variables left to bind for each run, in the order `prime()`
+        # finds for them
+        self._variables = [ element for element in transform._variables
+                            if element._name not in context.variables ]
+        return
+
+    def prime(self, context):
+        """
+        Readies `context` (a clone of the prepared context) for a run, by
+        doing the document-dependent part of `transform.root.prime()`.
+        """
+        source_nodes = self._transform.root.sourceNodes
+        if source_nodes:
+            context.documents.update(source_nodes)
+        self._transform.prime(context, self._variables)
+        return
+
+    def _execute(self, node, result):
+        if result is None:
+            result = stringresult()
+        result.parameters = self._output_parameters
+        assert result.writer
+        context = self._context.clone(node, result.parameters)
+        return self.processor._process(context, result, self)
+
+    def run(self, source, result=None):
+        """
+        Transform a source document as given via an InputSource.
+        """
+        try:
+            document = tree.parse(source)
+        except ReaderError, e:
+            raise XsltError(XsltError.SOURCE_PARSE_ERROR,
+                            uri=(source.uri or '<Python string>'), text=e)
+        return self._execute(document, result)
+
+    def run_node(self, node, result=None):
+        """
+        Transform a source document as given via an Amara tree node.
+        """
+        return self._execute(node, result)
@@ -246,6 +246,7 @@ static struct PyMethodDef root_methods[] = {
 static struct PyMemberDef root_members[] = {
   XsltRoot_MEMBER(baseUri, 0),
   XsltRoot_MEMBER(stylesheet, READONLY),
+  XsltRoot_MEMBER(prime_instructions, READONLY),
   XsltRoot_MEMBER(sources, READONLY),
   XsltRoot_MEMBER(sourceNodes, READONLY),
   { NULL }
@@ -7,6 +7,7 @@ Implementation of `xsl:attribute` element
 from amara.namespaces import XSL_NAMESPACE
 from amara.xslt import XsltError
 from amara.xslt.tree import xslt_element, content_model, attribute_types
+from amara.xslt.expressions import _get_text_parts
 
 class attribute_element(xslt_element):
     content_model = content_model.template
@@ -53,3 +54,34 @@ class attribute_element(xslt_element):
             writer = context.pop_writer()
         context.attribute(name, writer.get_result(), namespace)
         return
+
+    def static_attribute(self):
+        """
+        Returns the (name, namespace, value) of the attribute created by this
+        instruction when none of them depend upon the context, otherwise None.
+        """
+        if not self._name.constant:
+            return None
+        if self._namespace and not self._namespace.constant:
+            return None
+        parts = _get_text_parts(self)
+        if parts is None or [ part for part in parts
+                              if not isinstance(part, unicode) ]:
+            return None
+        # Any errors are left to be reported by `instantiate()`
+        prefix, name = self._name.evaluate(None)
+        if prefix:
+            name = prefix + u':' + name
+        elif name == 'xmlns':
+            return None
+        if not self._namespace:
+            if prefix is not None:
+                try:
+                    namespace = self.namespaces[prefix]
+                except KeyError:
+                    return None
+            else:
+                namespace = None
+        else:
+            namespace = self._namespace.evaluate_as_string(None) or None
+        return (name, namespace, u''.join(parts))
@@ -7,6 +7,7 @@ Implementation of the top-level elements.
 from amara.namespaces import XSL_NAMESPACE, EXTENSION_NAMESPACE
 from amara.xslt import XsltError
 from amara.xslt.tree import xslt_element, content_model, attribute_types
+from amara.xslt.tree.attribute_element import attribute_element
 
 __all__ = (
     'import_element', 'include_element', 'strip_space_element',
@@ -157,3 +158,32 @@ class attribute_set_element(xslt_element):
         context.variables = variables
         used.remove(self)
         return
+
+    def static_attributes(self, attribute_sets, used=()):
+        """
+        Returns the list of (name, namespace, value) for the attributes
+        created by this attribute set, including those from the attribute
+        sets it uses, when none of them depend upon the context, otherwise
+        None.
+        """
+        if self in used:
+            return None
+        used += (self,)
+        attributes = []
+        for name in self._use_attribute_sets:
+            try:
+                attribute_set = attribute_sets[name]
+            except KeyError:
+                return None
+            static = attribute_set.static_attributes(attribute_sets, used)
+            if static is None:
+                return None
+            attributes.extend(static)
+        for child in self.children:
+            if not isinstance(child, attribute_element):
+                return None
+            static = child.static_attribute()
+            if static is None:
+                return None
+            attributes.append(static)
+        return attributes
@@ -14,6 +14,9 @@ class literal_element(xslt_element):
     # usually not supplied so default it
     _use_attribute_sets = None
 
+    # the attribute emission plan; see `_prepare_attributes()`
+    _attribute_plan = None
+
     # This will be called by the stylesheet if it contains any
     # xsl:namespace-alias declarations
     def fixup_aliases(self, aliases):
@@ -42,8 +45,58 @@ class literal_element(xslt_element):
                 # get the aliased namespace and set that pairing
                 namespace, prefix = aliases[namespace]
                 self._output_nss[prefix] = namespace
+
+        # the emission plan is based on the unaliased names
+        self._attribute_plan = None
         return
 
+    def _prepare_attributes(self, transform):
+        """
+        Compiles the attributes for the element into a sequence of
+        (name, namespace, value) where the value is the string value for
+        constant attributes or the AVT for the others, and the names of the
+        attribute sets which must be instantiated for each element.
+        """
+        attributes = []
+        for name, namespace, value in self._output_attrs:
+            if value.constant:
+                value = value.evaluate_as_string(None)
+            attributes.append((name, namespace, value))
+
+        attribute_sets = self._use_attribute_sets
+        if attribute_sets:
+            # Attribute sets whose attributes do not depend upon the context
+            # are expanded in place, but only when they all are as attribute
+            # order within the element determines which value is used.
+            static = []
+            for name in attribute_sets:
+                try:
+                    attribute_set = transform.attribute_sets[name]
+                except KeyError:
+                    break
+                expanded = attribute_set.static_attributes(
+                    transform.attribute_sets)
+                if expanded is None:
+                    break
+                static.extend(expanded)
+            else:
+                attributes.extend(static)
+                attribute_sets = None
+
+        # Later attributes replace earlier ones with the same expanded name
+        # so only the last needs to be written.
+        plan, positions = [], {}
+        for attribute in attributes:
+            name, namespace = attribute[:2]
+            key = (namespace, name[name.find(':')+1:])
+            if key in positions:
+                plan[positions[key]] = None
+            positions[key] = len(plan)
+            plan.append(attribute)
+        plan = tuple(attribute for attribute in plan if attribute)
+        self._attribute_plan = (transform, plan, attribute_sets)
+        return self._attribute_plan
+
     def instantiate(self, context):
         context.instruction = self
         context.namespaces = self.namespaces
@@ -51,11 +104,17 @@ class literal_element(xslt_element):
         context.start_element(self.nodeName, self._output_namespace,
                               self._output_nss)
 
-        for name, namespace, value in self._output_attrs:
-            value = value.evaluate(context)
+        plan = self._attribute_plan
+        if plan is None or plan[0] is not context.transform:
+            plan = self._prepare_attributes(context.transform)
+        transform, attributes, attribute_sets = plan
+
+        for name, namespace, value in attributes:
+            if not isinstance(value, unicode):
+                value = value.evaluate(context)
             context.attribute(name, value, namespace)
 
-        if self._use_attribute_sets:
+        if attribute_sets:
             attribute_sets = context.transform.attribute_sets
             for name in self._use_attribute_sets:
                 try:
@@ -47,6 +47,18 @@ class number_element(xslt_element):
         elif self._level == 'any':
             self._level = ANY
 
+        # The values computed for a count (and from) pattern can only be
+        # reused if the patterns do not depend upon anything which changes
+        # between instantiations (variable bindings or the current node).
+        # As for predicated patterns, a '$' in a string literal just
+        # disables the reuse.
+        self._memoize = True
+        for pattern in (self._count, self._from):
+            if pattern:
+                expr = unicode(pattern)
+                if '$' in expr or 'current(' in expr:
+                    self._memoize = False
+
         if self._format.constant and self._lang.constant:
             format = self._format.evaluate_as_string(None)
             lang = self._lang.evaluate_as_string(None)
@@ -113,28 +125,49 @@ class number_element(xslt_element):
                                           separator)
             else:
                 # 'single' without count or from attributes
-                value = 1
-                prev = node.xml_preceding_sibling
-                node_type = node.xml_type
-                node_name = node.xml_name
-                while prev:
-                    if prev.xml_type == node_type and \
-                       prev.xml_name == node_name:
-                        value += 1
-                    prev = prev.xml_preceding_sibling
+                count = name_pattern(node.xml_type, node.xml_name)
+                value = self._sibling_number(context, node, count)
                 result = formatter.format(value, letter_value, grouping,
                                           separator)
         # add the resulting formatted value(s) to the result tree
         context.text(result)
         return
 
+    def _sibling_number(self, context, node, count):
+        # The 1-based position of `node` amongst its siblings matching
+        # `count`.  The positions are remembered for the duration of the
+        # transform, so numbering the siblings in document order only has
+        # to scan back to the previously numbered one.
+        if not self._memoize:
+            numbers = {}
+        else:
+            try:
+                numbers = context.numbering[count]
+            except KeyError:
+                numbers = context.numbering[count] = {}
+        if node in numbers:
+            return numbers[node]
+        pending = [node]
+        value = 0
+        prev = node.xml_preceding_sibling
+        while prev:
+            if prev in numbers:
+                value = numbers[prev]
+                break
+            if count.match(context, prev):
+                pending.append(prev)
+            prev = prev.xml_preceding_sibling
+        for node in reversed(pending):
+            value += 1
+            numbers[node] = value
+        return value
+
     def _single_value(self, context, node, countPattern, fromPattern):
         if not countPattern:
-            if not node.xml_local:
-                # text, comment and processing instruction
-                countPattern = NodeTypeTest(node)
+            if isinstance(node, (tree.element, tree.attribute)):
+                countPattern = name_pattern(node.xml_type, node.xml_name)
             else:
-                countPattern = NameTest(node)
+                countPattern = type_pattern(node.xml_type)
 
         if fromPattern:
             start = node.xml_parent
@@ -147,14 +180,7 @@ class number_element(xslt_element):
             node = node.xml_parent
             if node is None or node == start:
                 return 0
-
-        value = 0
-        while node:
-            value += 1
-            node = node.xml_preceding_sibling
-            while node and not countPattern.match(context, node):
-                node = node.xml_preceding_sibling
-        return value
+        return self._sibling_number(context, node, countPattern)
 
     def _multiple_values(self, context, node):
         count = self._count
@@ -167,7 +193,7 @@ class number_element(xslt_element):
         values = []
         while node:
             if count.match(context, node):
-                value = self._single_value(context, node, count,  None)
+                value = self._sibling_number(context, node, count)
                 values.insert(0, value)
             node = node.xml_parent
             if node and self._from and self._from.match(context, node):
@@ -182,8 +208,24 @@ class number_element(xslt_element):
             else:
                 count = type_pattern(node.xml_type)
 
+        # The value for a node is the number of matching nodes on the
+        # reverse document order walk up to the `from` boundary.  Once the
+        # walk reaches a node that was numbered before, the rest of the
+        # walk is identical to that node's, so its value is reused.
+        if not self._memoize:
+            numbers = {}
+        else:
+            key = (count, self._from)
+            try:
+                numbers = context.numbering[key]
+            except KeyError:
+                numbers = context.numbering[key] = {}
+        start = node
         value = 0
         while node:
+            if node in numbers:
+                value += numbers[node]
+                break
             if self._from and self._from.match(context, node):
                 break
             if count.match(context, node):
@@ -197,6 +239,7 @@ class number_element(xslt_element):
                 while next:
                     node = next
                     next = getattr(node, 'xml_last_child', None)
+        numbers[start] = value
         return value
 
 
@@ -205,6 +248,13 @@ class type_pattern:
         self.xml_type = xml_type
         return
 
+    def __eq__(self, other):
+        return (isinstance(other, type_pattern) and
+                self.xml_type == other.xml_type)
+
+    def __hash__(self):
+        return hash(self.xml_type)
+
     def match(self, context, node):
         return (node.xml_type == self.xml_type)
 
@@ -215,6 +265,14 @@ class name_pattern:
         self.xml_name = xml_name
         return
 
+    def __eq__(self, other):
+        return (isinstance(other, name_pattern) and
+                self.xml_type == other.xml_type and
+                self.xml_name == other.xml_name)
+
+    def __hash__(self):
+        return hash((self.xml_type, self.xml_name))
+
     def match(self, context, node):
         return (node.xml_type == self.xml_type and
                 node.xml_name == self.xml_name)
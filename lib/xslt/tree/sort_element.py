@@ -22,45 +22,54 @@ class sort_element(xslt_element):
                                                   'lower-first')),
         }
 
-    # Using `object` as a sentinel as `None` is a valid compare function
+    # Using `object` as a sentinel as `None` is a valid collation function
     _missing = object()
-    _compare = _missing
-    _reverse = _missing
+    _data_type_value = _missing
+    _collate = _missing
 
     def setup(self):
         # optimize for constant AVT attribute values (i.e., no {})
-        if self._data_type.constant and self._case_order.constant:
-            self._compare = self._get_compare(self._data_type.evaluate(None),
-                                              self._case_order.evaluate(None))
-        if self._order.constant:
-            self._reverse = self._order.evaluate(None) == 'descending'
+        if self._data_type.constant:
+            self._data_type_value = self._data_type.evaluate(None)
+            if self._case_order.constant and self._order.constant:
+                self._collate = self._get_collate(
+                    self._data_type_value, self._case_order.evaluate(None),
+                    self._order.evaluate(None) == 'descending')
         return
 
-    def _get_compare(self, data_type, case_order):
+    def _get_collate(self, data_type, case_order, reverse):
         if data_type == 'number':
-            comparer = _number_compare
-        else:
-            if case_order == 'lower-first':
-                comparer = _lower_first_compare
-            elif case_order == 'upper-first':
-                comparer = _upper_first_compare
-            else:
-                # use default for this locale
-                comparer = None
-        return comparer
-
-    def get_parameters(self, context, _missing=_missing):
-        compare, reverse = self._compare, self._reverse
-        if compare is _missing:
+            if reverse:
+                return _number_keys_descending
+            return _number_keys
+        if case_order == 'lower-first':
+            return _ranked_keys(_lower_first_compare, reverse)
+        elif case_order == 'upper-first':
+            return _ranked_keys(_upper_first_compare, reverse)
+        elif reverse:
+            return _ranked_keys(None, True)
+        # use default for this locale; the keys already compare correctly
+        return None
+
+    def get_collation(self, context, _missing=_missing):
+        """
+        Returns a function mapping the list of keys returned by `get_key()`
+        to a list of values which, compared with the builtin comparison,
+        produce the ordering requested by this `xsl:sort`.  `None` is
+        returned when the keys can be used as is.
+        """
+        collate = self._collate
+        if collate is _missing:
             data_type = self._data_type.evaluate(context)
             case_order = self._case_order and self._case_order.evaluate(context)
-            compare = self._get_compare(data_type, case_order)
-        if reverse is _missing:
             reverse = self._order.evaluate(context) == 'descending'
-        return (compare, reverse)
+            collate = self._get_collate(data_type, case_order, reverse)
+        return collate
 
-    def get_key(self, context):
-        data_type = self._data_type.evaluate(context)
+    def get_key(self, context, _missing=_missing):
+        data_type = self._data_type_value
+        if data_type is _missing:
+            data_type = self._data_type.evaluate(context)
         if data_type == 'text':
             # Use "real" strings as XPath string objects implement
             # XPath semantics for relational (<,>) operators.
@@ -70,16 +79,33 @@ class sort_element(xslt_element):
         return self._select.evaluate(context)
 
 
-### Comparision Functions ###
+### Collation Functions ###
+
+# NaN seems to always equal everything else, so it is replaced by a value
+# that sorts before (or, when descending, after) every real number.  The
+# IEEE definition of NaN makes it the smallest possible number.
+def _number_keys(keys):
+    return [ (0,) if key.isnan() else (1, key) for key in keys ]
 
-def _number_compare(a, b):
-    # NaN seems to always equal everything else, so we'll do it ourselves
-    # the IEEE definition of NaN makes it the smallest possible number
-    if a.isnan():
-        return 0 if b.isnan() else -1
-    elif b.isnan():
-        return 1
-    return cmp(a, b)
+def _number_keys_descending(keys):
+    return [ (1,) if key.isnan() else (0, -key) for key in keys ]
+
+def _ranked_keys(compare, reverse):
+    # Replaces each key with its rank amongst the distinct keys.  Only the
+    # distinct values are ordered (using `compare`), so any per-comparison
+    # callback runs over the unique keys instead of over every node.
+    def collate(keys):
+        distinct = sorted(set(keys), cmp=compare)
+        if reverse:
+            ranks = xrange(len(distinct), 0, -1)
+        else:
+            ranks = xrange(len(distinct))
+        ranks = dict(zip(distinct, ranks))
+        return map(ranks.__getitem__, keys)
+    return collate
+
+
+### Comparision Functions ###
 
 def _lower_first_compare(a, b):
     # case only matters if the strings are equal ignoring case
@@ -106,6 +106,15 @@ class _key_dispatch_table(dict):
                 match_table[type_key] = tuple(patterns)
         self._matches_attribute = tree.attribute.xml_typecode in match_table
 
+    def new(self):
+        """
+        Returns an empty table which shares the match tables of this one.
+        """
+        table = dict.__new__(self.__class__)
+        table._match_table = self._match_table
+        table._matches_attribute = self._matches_attribute
+        return table
+
     def _match_nodes(self, context, nodes):
         initial_focus = context.node, context.position, context.size
         context.size = len(nodes)
@@ -292,6 +301,7 @@ class transform_element(xslt_element):
         keys = self._keys = {}
         for name, elements in itertools.groupby(elements, name_key):
             keys[name] = tuple(elements)
+        self._key_tables = None
 
         # - process the `xsl:decimal-format` elements
         formats = self.decimal_formats = {}
@@ -460,9 +470,17 @@ class transform_element(xslt_element):
 
     ############################# Prime Routines #############################
 
-    def prime(self, context):
+    def prime(self, context, variables=None):
+        """
+        Binds the top-level variables and parameters in `context`, and sets
+        up its key tables.  `variables`, if given, is the list of variable
+        and parameter elements to consider instead of all of them; like
+        those, it is reordered so that later runs need not defer any.
+        """
+        if variables is None:
+            variables = self._variables
         processed = context.variables
-        elements, deferred = self._variables, []
+        elements, deferred = variables, []
         num_writers = len(context._writers)
         while 1:
             for element in elements:
@@ -486,14 +504,34 @@ class transform_element(xslt_element):
             # Re-order stored variable elements to simplify processing for
             # the next transformation.
             for element in deferred:
-                self._variables.remove(element)
-                self._variables.append(element)
+                variables.remove(element)
+                variables.append(element)
             # Try again, but this time processing only the ones that
             # referenced, as of yet, undefined variables.
             elements, deferred = deferred, []
 
-        for name, keys in self._keys.iteritems():
-            context.keys[name] = _key_dispatch_table(keys)
+        # The match tables only depend upon the key definitions, so build
+        # them once and give each run a fresh (empty) table sharing them.
+        key_tables = self._key_tables
+        if key_tables is None:
+            key_tables = self._key_tables = {}
+            for name, keys in self._keys.iteritems():
+                key_tables[name] = _key_dispatch_table(keys)
+        for name, key_table in key_tables.iteritems():
+            context.keys[name] = key_table.new()
+        return
+
+    def prime_constants(self, context):
+        """
+        Binds the top-level variables and parameters whose values do not
+        depend upon the source document (those with literal values) in
+        `context`.  Parameters already bound in the context are skipped, as
+        they are by `prime()`.
+        """
+        processed = context.variables
+        for element in self._variables:
+            if element.constant and element._name not in processed:
+                element.instantiate(context)
         return
 
     def update_keys(self, context):
@@ -4,8 +4,10 @@
 Implementation of XSLT variable assigning elements
 """
 
+from amara.xpath.expressions.basics import literal
 from amara.xslt import XsltError
 from amara.xslt.tree import xslt_element, content_model, attribute_types
+from amara.xslt.expressions import rtf_expression, _get_text_parts
 
 __all__ = ['variable_element', 'param_element']
 
@@ -19,10 +21,21 @@ class variable_element(xslt_element):
         'select': attribute_types.expression(),
         }
 
+    # true if the value does not depend upon the context
+    constant = False
+
     def setup(self):
         # check for a bad binding
         if self._select and self.children:
             raise XsltError(XsltError.VAR_WITH_CONTENT_AND_SELECT, name=self._name)
+        if self.children:
+            parts = _get_text_parts(self)
+            self.constant = parts is not None and not [
+                part for part in parts if not isinstance(part, unicode) ]
+            self._select = rtf_expression(self)
+        else:
+            self.constant = not self._select or isinstance(self._select,
+                                                           literal)
         return
 
     def instantiate(self, context):
@@ -31,11 +44,6 @@ class variable_element(xslt_element):
             context.instruction = self
             context.namespaces = self.namespaces
             result = self._select.evaluate(context)
-        elif self.children:
-            context.push_tree_writer(self.base_uri)
-            self.process_children(context)
-            writer = context.pop_writer()
-            result = writer.get_result()
         else:
             result = u""
         context.variables[self._name] = result
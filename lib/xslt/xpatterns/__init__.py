@@ -94,15 +94,41 @@ class predicated_test(nodetests.node_test):
         self._predicates = predicates
         self.name_key = node_test.name_key
         self.node_type = node_test.node_type
+        # The matching siblings can be shared by all the nodes having the
+        # same parent as long as the predicates do not depend upon anything
+        # which changes while processing the siblings (variable bindings or
+        # the current node).  The check is conservative: a '$' in a string
+        # literal just disables the sharing.
+        expr = unicode(predicates)
+        self._shared = '$' not in expr and 'current(' not in expr
         return
 
     def match(self, context, node, principal_type):
         parent = node.xml_parent
-        if principal_type == tree.attribute:
-            nodes = parent.xml_attributes.nodes()
-        elif not parent:
+        if principal_type != tree.attribute and not parent:
             # Must be a document
             return False
+        if self._shared:
+            # Filtering the siblings once per parent keeps matching linear
+            # in the number of siblings.  Only the most recent parent is
+            # kept as the siblings are (usually) processed together.
+            try:
+                matches = context.pattern_matches
+            except AttributeError:
+                pass
+            else:
+                entry = matches.get(self)
+                if (entry is None or entry[0] is not parent
+                    or entry[1] is not principal_type):
+                    nodes = frozenset(self._filter(context, parent,
+                                                   principal_type))
+                    entry = matches[self] = (parent, principal_type, nodes)
+                return node in entry[2]
+        return node in self._filter(context, parent, principal_type)
+
+    def _filter(self, context, parent, principal_type):
+        if principal_type == tree.attribute:
+            nodes = parent.xml_attributes.nodes()
         else:
             # Amara nodes are iterable (over their children)
             nodes = parent
@@ -112,8 +138,7 @@ class predicated_test(nodetests.node_test):
                   if self._node_test.match(context, node, principal_type) )
 
         # Child and attribute axes are forward only
-        nodes = self._predicates.filter(nodes, context, reverse=False)
-        return node in nodes
+        return self._predicates.filter(nodes, context, reverse=False)
 
     def __str__(self):
         return str(self._node_test) + str(self._predicates)
@@ -49,10 +49,33 @@ class xsltcontext(context):
         self.transform = transform
         self.processor = processor
         self.mode = mode
-        self.documents = uridict()
+        self._documents = None
+        self._added_documents = []
         self.keys = {}
+        self.numbering = {}
+        self.pattern_matches = {}
         return
 
+    def clone(self, node, output_parameters=None):
+        """
+        Returns a new context for processing the document `node`, which
+        starts out with the global variables and the functions of this one.
+        """
+        context = self.__class__.__new__(self.__class__)
+        context.__dict__.update(self.__dict__)
+        context.output_parameters = output_parameters
+        context.node, context.position, context.size = node, 1, 1
+        context.variables = self.variables.copy()
+        context.global_variables = dictproxy(context.variables)
+        context.functions = self.functions.copy()
+        context._writers = []
+        context._documents = None
+        context._added_documents = []
+        context.keys = {}
+        context.numbering = {}
+        context.pattern_matches = {}
+        return context
+
     def get(self):
         return self._current_instruction
     def set(self, value):
@@ -61,10 +84,25 @@ class xsltcontext(context):
     current_instruction = property(get, set)
     del get, set
 
+    def get(self):
+        documents = self._documents
+        if documents is None:
+            documents = self._documents = uridict()
+            for document_uri, document in self._added_documents:
+                documents[document_uri] = document
+        return documents
+    documents = property(get)
+    del get
+
     def add_document(self, document, document_uri=None):
         # RTF documents do not have a documentUri
         if document_uri:
-            self.documents[document_uri] = document
+            # Normalizing the URI is a noticeable part of a short run, so
+            # the documents are only indexed once they are looked up.
+            if self._documents is None:
+                self._added_documents.append((document_uri, document))
+            else:
+                self._documents[document_uri] = document
         return
 
     def update_keys(self):
@@ -4,6 +4,8 @@
 XUpdate request processing
 """
 
+import sys
+
 from amara import tree
 from amara.lib.xmlstring import splitqname
 from amara.xpath import context
@@ -30,6 +32,40 @@ __all__ = [
 # upd:rename                 xupdate:rename
 
 
+class children_plan(object):
+    """
+    The changes a command makes to the children of the nodes it selects,
+    collected a parent at a time so that each parent is rebuilt with a
+    single `xml_splice` rather than a splice (and index search) per target.
+    """
+    __slots__ = ('_parents',)
+    def __init__(self):
+        self._parents = {}
+
+    def replace(self, child, nodes):
+        """Schedule `child` to be replaced by the sequence `nodes`"""
+        parent = child.xml_parent
+        try:
+            changes = self._parents[id(parent)][1]
+        except KeyError:
+            changes = {}
+            self._parents[id(parent)] = (parent, changes)
+        changes[id(child)] = nodes
+
+    def apply(self):
+        for parent, changes in self._parents.itervalues():
+            children = []
+            for child in parent.xml_children:
+                nodes = changes.get(id(child))
+                if nodes is None:
+                    children.append(child)
+                else:
+                    children.extend(nodes)
+            parent.xml_splice(0, sys.maxint, children)
+        self._parents.clear()
+        return
+
+
 class modifications_list(xupdate_primitive):
 
     def apply_updates(self, document):
@@ -81,18 +117,10 @@ class append_command(xupdate_command):
                     position = int(self.child.evaluate_as_number(context))
                 finally:
                     context.node, context.position, context.size = focus
-                if position < size:
-                    refnode = target.xml_children[position]
-                else:
-                    refnode = None
+                offset = min(position, size)
             else:
-                refnode = None
-            while tr.xml_first_child:
-                if refnode is not None:
-                    offset = target.xml_index(refnode)
-                    target.xml_insert(offset, tr.xml_first_child)
-                else:
-                    target.xml_append(tr.xml_first_child)
+                offset = sys.maxint
+            target.xml_splice(offset, offset, tr.xml_children)
         return
 
 
@@ -124,13 +152,14 @@ class rename_command(xupdate_command):
         targets = self.select.evaluate_as_nodeset(context)
         if not targets:
             raise XUpdateError(XUpdateError.INVALID_SELECT)
+        replacements = []
         for target in targets:
-            parent = target.xml_parent
             if target.xml_type == tree.attribute.xml_type:
+                parent = target.xml_parent
                 parent.xml_attributes[namespace, name] = target.xml_value
             elif target.xml_type == tree.processing_instruction.xml_type:
                 pi = tree.processing_instruction(name, target.xml_data)
-                parent.xml_replace-child(pi, target)
+                replacements.append((target, pi))
             elif target.xml_type == tree.element.xml_type:
                 #FIXME: Use regular constructor. No more DOM factory
                 element = tree.element(namespace, name)
@@ -138,10 +167,15 @@ class rename_command(xupdate_command):
                 if target.xml_attributes:
                     for (ns, qname), value in target.xml_attributes.iteritems():
                         element.xml_attributes[ns, qname] = value
-                # Now copy any children as well
-                while target.xml_first_child:
-                    element.xml_append(target.xml_first_child)
-                parent.xml_replace(target, element)
+                # Now move any children as well
+                element.xml_splice(0, 0, target.xml_children)
+                replacements.append((target, element))
+        # The targets are only swapped out once all of the children have
+        # moved, as a target may itself have been moved into a new element.
+        plan = children_plan()
+        for target, node in replacements:
+            plan.replace(target, (node,))
+        plan.apply()
         return
 
 
@@ -160,16 +194,15 @@ class insert_before_command(xupdate_command):
 
     def instantiate(self, context):
         context.namespaces = self.namespaces
+        plan = children_plan()
         for target in self.select.evaluate_as_nodeset(context):
             context.push_tree_writer(target.xml_base)
             for primitive in self:
                 primitive.instantiate(context)
             writer = context.pop_writer()
             tr = writer.get_result()
-            parent = target.xml_parent
-            while tr.xml_first_child:
-                offset = parent.xml_index(target)
-                parent.xml_insert(offset, tr.xml_first_child)
+            plan.replace(target, tr.xml_children + (target,))
+        plan.apply()
         return
 
 
@@ -188,20 +221,15 @@ class insert_after_command(xupdate_command):
 
     def instantiate(self, context):
         context.namespaces = self.namespaces
+        plan = children_plan()
         for target in self.select.evaluate_as_nodeset(context):
             context.push_tree_writer(target.xml_base)
             for primitive in self:
                 primitive.instantiate(context)
             writer = context.pop_writer()
-            tree = writer.get_result()
-            parent = target.xml_parent
-            target = target.xml_following_sibling
-            while tree.xml_first_child:
-                if target is not None:
-                    offset = parent.xml_index(target)
-                    parent.xml_insert(offset, tree.xml_first_child)
-                else:
-                    parent.xml_append(tree.xml_first_child)
+            tr = writer.get_result()
+            plan.replace(target, (target,) + tr.xml_children)
+        plan.apply()
         return
 
 
@@ -223,6 +251,7 @@ class update_command(xupdate_command):
         targets = self.select.evaluate_as_nodeset(context)
         if not targets:
             raise XUpdateError(XUpdateError.INVALID_SELECT)
+        plan = children_plan()
         for target in targets:
             if target.xml_type == tree.element.xml_type:
                 context.push_tree_writer(target.xml_base)
@@ -230,10 +259,7 @@ class update_command(xupdate_command):
                     primitive.instantiate(context)
                 writer = context.pop_writer()
                 tr = writer.get_result()
-                while target.xml_first_child:
-                    target.xml_remove(target.xml_first_child)
-                while tr.xml_first_child:
-                    target.xml_append(tr.xml_first_child)
+                target.xml_splice(0, sys.maxint, tr.xml_children)
             elif target.xml_type in (tree.attribute.xml_type,
                                      tree.text.xml_type,
                                      tree.comment.xml_type,
@@ -244,9 +270,10 @@ class update_command(xupdate_command):
                 writer = context.pop_writer()
                 value = writer.get_result()
                 if not value and target.xml_type == tree.text.xml_type:
-                    target.xml_parent.xml_remove(target)
+                    plan.replace(target, ())
                 else:
                     target.xml_value = value
+        plan.apply()
         return
 
 
@@ -265,13 +292,15 @@ class remove_command(xupdate_command):
 
     def instantiate(self, context):
         context.namespaces = self.namespaces
+        plan = children_plan()
         for target in self.select.evaluate_as_nodeset(context):
             parent = target.xml_parent
-            if parent:
+            if parent is not None:
                 if target.xml_type == tree.attribute.xml_type:
                     del parent.xml_attributes[target]
                 else:
-                    parent.xml_remove(target)
+                    plan.replace(target, ())
+        plan.apply()
         return
 
 
@@ -358,6 +358,8 @@ setup(name='Amara',
                              'lib/src/domlette/namespace.c',
                              # Document builder
                              'lib/src/domlette/builder.c',
+                             # Binary tree images
+                             'lib/src/domlette/binary.c',
                              # Reference count testing
                              'lib/src/domlette/refcounts.c',
                              # Rule matcher
@@ -373,6 +375,9 @@ setup(name='Amara',
                     include_dirs=['lib/src', 'lib/src/domlette'],
                     sources=['lib/writers/src/treewriter.c'],
                     ),
+          Extension('amara.lib._iri',
+                    sources=['lib/lib/src/iri.c'],
+                    ),
           Extension('amara.xpath._datatypes',
                     include_dirs=['lib/src/domlette'],
                     sources=['lib/xpath/src/datatypes.c'],
@@ -399,6 +404,9 @@ setup(name='Amara',
           Extension('amara.xslt.functions._functions',
                     sources=['lib/xslt/functions/src/decimal_format.c'],
                     ),
+          Extension('amara.xslt.exslt._iso8601',
+                    sources=['lib/xslt/exslt/src/iso8601.c'],
+                    ),
           Extension('amara.xslt.xpatterns._parser',
                     sources=['lib/xslt/xpatterns/parser.c'],
                     define_macros=[('BisonGen_FORWARDS_COMPATIBLE', None)],
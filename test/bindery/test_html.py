@@ -49,6 +49,17 @@ def test_simple_attr_update3():
     return
 
 
+def test_text_coalescing():
+    EXPECTED = '<html><head/><body><div>a &amp; bxy<table><tbody><tr><td>1</td></tr></tbody></table><b>c</b>d &lt; e</div></body></html>'
+    doc = html.parse('<div>a &amp; b<table>x<tr><td>1</td></tr>y</table><b>c</b>d &lt; e</div>')
+    treecompare.check_xml(doc.xml_encode(), XMLDECL+EXPECTED)
+    #Adjacent text (including text foster parented out of the table) is one node
+    div = doc.xml_select(u'//div')[0]
+    assert [ c.xml_type for c in div.xml_children ] == ['text', 'element', 'element', 'text']
+    assert div.xml_first_child.xml_value == u'a & bxy', div.xml_first_child.xml_value
+    return
+
+
 #XXX The rest are in old unittest style.  Probably best to add new test cases above in nose test style
 
 #This test crashes (maximum recursion) using html5lib 0.90.0
@@ -8,6 +8,64 @@ from amara.lib import U
 from amara import bindery
 from amara.bindery.model import examplotron_model, generate_metadata
 
+from amara.bindery.model import constraint, attribute_constraint
+
+
+MONTY_XML = """<monty>
+  <python spam="eggs">What do you mean "bleh"</python>
+  <python ministry="abuse">But I was looking for argument</python>
+</monty>"""
+
+
+def test_constraint_validation():
+    doc = bindery.parse(MONTY_XML)
+    c = constraint(u'@ministry')
+    try:
+        doc.monty.python.xml_model.add_constraint(c, validate=True)
+    except bindery.BinderyError:
+        pass
+    else:
+        raise AssertionError('constraint violation not detected')
+    doc.monty.python.xml_attributes[None, u'ministry'] = u'argument'
+    doc.monty.python.xml_model.validate()
+    return
+
+
+def test_constraint_fixup():
+    doc = bindery.parse(MONTY_XML)
+    c = attribute_constraint(None, u'ministry', u'nonesuch')
+    doc.monty.python.xml_model.add_constraint(c, validate=True)
+    assert [ p.ministry for p in doc.monty.python ] == [u'nonesuch', u'abuse']
+    return
+
+
+def test_incremental_validation():
+    doc = bindery.parse(MONTY_XML)
+    checked = []
+    def assertion(node):
+        checked.append(node)
+        return u'true()'
+    model = doc.monty.python.xml_model
+    model.add_constraint(constraint(assertion, incremental=True), validate=True)
+    assert len(checked) == 2
+    #Unchanged elements are not checked again
+    del checked[:]
+    model.validate()
+    assert checked == []
+    #Only the changed element is
+    second = list(doc.monty.python)[1]
+    second.xml_attributes[None, u'spam'] = u'spam'
+    model.validate()
+    assert checked == [second]
+    #Constraints that are not incremental are always checked
+    del checked[:]
+    model.add_constraint(constraint(assertion), validate=True)
+    assert len(checked) == 2
+    del checked[:]
+    model.validate()
+    assert len(checked) == 2
+    return
+
 
 if __name__ == '__main__':
     from amara.test import test_main
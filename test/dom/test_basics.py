@@ -91,5 +91,42 @@ class Test_attributes(unittest.TestCase):
         for k in [(None, 'g'), (None, 'h'), (None, 'z')]:
             self.assertFalse(k in attrs)
 
+class Test_elements_by_tag_name(unittest.TestCase):
+    def test_subtree(self):
+        "Only descendants of the context node are returned"
+        doc = parse('<doc><a><b id="1"/></a><b id="2"/><a><b id="3"/></a></doc>')
+        ids = lambda nodes: [ e.getAttributeNS(None, u'id') for e in nodes ]
+        self.assertEqual(ids(doc.getElementsByTagNameNS(None, u'b')),
+                         [u'1', u'2', u'3'])
+        second = doc.documentElement.childNodes[2]
+        self.assertEqual(ids(second.getElementsByTagNameNS(None, u'b')), [u'3'])
+        self.assertEqual(ids(second.getElementsByTagName(u'b')), [u'3'])
+
+    def test_wildcards(self):
+        "'*' matches any namespace or local name"
+        doc = parse(NS_XML)
+        names = lambda nodes: [ e.nodeName for e in nodes ]
+        self.assertEqual(names(doc.getElementsByTagNameNS(u'*', u'*')),
+                         [u'doc', u'a:monty', u'b:python'])
+        self.assertEqual(names(doc.getElementsByTagNameNS(u'urn:bogus:b', u'*')),
+                         [u'b:python'])
+        self.assertEqual(names(doc.getElementsByTagNameNS(u'*', u'monty')),
+                         [u'a:monty'])
+        self.assertEqual(names(doc.getElementsByTagName(u'b:python')),
+                         [u'b:python'])
+        self.assertEqual(names(doc.getElementsByTagName(u'python')), [])
+
+    def test_mutation(self):
+        "Lookups reflect changes made to the tree"
+        doc = parse(MONTY_XML)
+        count = lambda: len(list(doc.getElementsByTagNameNS(None, u'python')))
+        self.assertEqual(count(), 2)
+        doc.documentElement.appendChild(doc.createElementNS(None, u'python'))
+        self.assertEqual(count(), 3)
+        doc.documentElement.firstChild.xml_local = u'spam'
+        self.assertEqual(count(), 2)
+        doc.documentElement.removeChild(doc.documentElement.lastChild)
+        self.assertEqual(count(), 1)
+
 if __name__ == '__main__':
     raise SystemExit("use nosetests")
@@ -1,7 +1,6 @@
 import os, unittest, sys, codecs
 import warnings
 from amara.lib import iri, irihelpers, inputsource
-from amara.test.lib import find_file
 
 # Test cases for BaseJoin() ==================================================
 # (base, relative, expected)
@@ -874,6 +873,25 @@ class Test_absolutize(unittest.TestCase):
             else:
                 self.assertEqual(expectedUri, res, 'base=%r ref=%r' % (baseUri, uriRef))
 
+    def test_types(self):
+        # results keep the string type of the arguments, even when they
+        # come from the memo of already resolved pairs
+        for i in range(2):
+            for ref, base in (('c/../d', 'http://a/b/'), (u'c/../d', 'http://a/b/'),
+                              ('c/../d', u'http://a/b/')):
+                res = iri.absolutize(ref, base)
+                self.assertEqual(res, 'http://a/b/d')
+                self.assertEqual(type(res), type(ref + base))
+        self.assertEqual(type(iri.absolutize('#f', u'http://a/b#g')), unicode)
+        self.assertEqual(iri.split_uri_ref(u'http://a/b?q#f'),
+                         (u'http', u'a', u'/b', u'q', u'f'))
+        self.assertEqual(type(iri.split_uri_ref(u'x')[2]), unicode)
+        self.assertEqual(iri.split_uri_ref('//a'), (None, 'a', '', None, None))
+        self.assertEqual(type(iri.remove_dot_segments(u'/a/./b/../c')), unicode)
+        self.assertRaises(iri.IriError, iri.absolutize, 'a', 'b/c')
+        self.assertRaises(iri.IriError, iri.absolutize, 'a', 'http://b/',
+                          limit_schemes=('ftp',))
+
 
 class Test_relativize(unittest.TestCase):
     '''Relativize'''
@@ -59,3 +59,53 @@ class Test_scheme_registry_resolver(unittest.TestCase):
             self.assertEqual(expected, res, "URI: base=%s uri=%s" % (base, relative))
 
 
+class Test_cached_resolver(unittest.TestCase):
+    '''cached_resolver'''
+    def test_cached_resolver(self):
+        uri = iri.os_path_to_uri(FILE('sampleresource.txt'))
+        seen = []
+        class counting_resolver(irihelpers.resolver):
+            def resolve(self, uriRef, baseUri=None):
+                seen.append(uriRef)
+                return irihelpers.resolver.resolve(self, uriRef, baseUri)
+        resolver = irihelpers.cached_resolver(counting_resolver())
+        for i in range(3):
+            isrc = inputsource(uri, resolver=resolver)
+            self.assertEqual('Spam', isrc.stream.read().strip())
+        self.assertEqual([uri], seen)
+        self.assert_(uri in resolver.cache)
+
+    def test_resource_cache_bounds(self):
+        cache = irihelpers.resource_cache(max_entries=2, max_bytes=10)
+        cache.put('http://example.com/a', 'aaaa')
+        cache.put('http://example.com/b', 'bbbb')
+        cache.get('http://example.com/a')
+        cache.put('http://example.com/c', 'cccc')
+        self.assertEqual(2, len(cache))
+        self.assertEqual(None, cache.get('http://example.com/b'))
+        self.assertEqual('aaaa', cache.get('HTTP://example.com/a'))
+        cache.put('http://example.com/d', 'dddddddd')
+        self.assertEqual(1, len(cache))
+        cache.put('http://example.com/e', 'x' * 11)
+        self.assertEqual(None, cache.get('http://example.com/e'))
+        # data too large to cache still replaces older data for the URI
+        cache.put('http://example.com/d', 'x' * 11)
+        self.assertEqual(None, cache.get('http://example.com/d'))
+        self.assertEqual(0, len(cache))
+
+    def test_external_entity(self):
+        seen = []
+        class counting_resolver(irihelpers.resolver):
+            def resolve(self, uriRef, baseUri=None):
+                seen.append(uriRef)
+                return irihelpers.resolver.resolve(self, uriRef, baseUri)
+        import amara
+        resolver = irihelpers.cached_resolver(counting_resolver())
+        base = iri.os_path_to_uri(FILE('test_irihelpers.py'))
+        doc = ('<!DOCTYPE a [<!ENTITY r SYSTEM "sampleresource.txt">]>'
+               '<a>&r;</a>')
+        for i in range(3):
+            tree = amara.parse(inputsource(doc, base, resolver=resolver))
+            self.assertEqual(u'Spam', tree.xml_select(u'string(a)').strip())
+        self.assertEqual(1, len(seen))
+
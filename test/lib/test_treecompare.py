@@ -0,0 +1,78 @@
+import unittest
+import cStringIO
+
+from amara.lib import treecompare
+
+class Test_xml_compare(unittest.TestCase):
+    'Testing amara.lib.treecompare.xml_compare and xml_diff'
+    def test_equivalent(self):
+        'Attribute order, namespace declarations and empty tags'
+        self.assert_(treecompare.xml_compare(
+            '<a xmlns:x="urn:x" xmlns:y="urn:y" p="1" q="2"><b/></a>',
+            '<a q="2" p="1" xmlns:y="urn:y" xmlns:x="urn:x"><b></b></a>'))
+        self.assert_(treecompare.xml_compare('<a> <b/> </a>', '<a><b/></a>',
+                                             whitespace=False))
+        self.failIf(treecompare.xml_compare('<a> <b/> </a>', '<a><b/></a>'))
+
+    def test_first_difference(self):
+        'The diff is located at the first differing event'
+        diff = list(treecompare.xml_diff('<a>\n<b/>\n<c/>\n</a>',
+                                         '<a>\n<b/>\n<d/>\n</a>'))
+        self.assertEquals(diff[:7], [
+            '--- expected',
+            '+++ compared',
+            '@@ event 6: expected line 3, compared line 3 @@',
+            ' end-tag: b',
+            " #text: u'\\n'",
+            '-start-tag: c',
+            '-end-tag: c',
+            ])
+        self.assertEquals(diff[7:9], ['+start-tag: d', '+end-tag: d'])
+
+    def test_missing_events(self):
+        'One document ends before the other'
+        diff = list(treecompare.xml_diff('<a><b/></a>', '<a><b/><c/></a>'))
+        self.assertEquals(diff[2], '@@ event 4: expected line 1, '
+                                   'compared line 1 @@')
+        self.assertEquals(diff[5:7], ['+start-tag: c', '+end-tag: c'])
+
+    def test_streams(self):
+        'Large documents and file-like objects are compared a chunk at a time'
+        doc = '<r>%s</r>' % ('<i n="1">text &amp; more</i>\n' * 20000)
+        self.assert_(treecompare.xml_compare(cStringIO.StringIO(doc), doc))
+        changed = doc[:-100] + 'X' + doc[-99:]
+        diff = list(treecompare.xml_diff(doc, cStringIO.StringIO(changed)))
+        self.assertEquals(diff[2], '@@ event 99984: expected line 19997, '
+                                   'compared line 19997 @@')
+        self.assert_(treecompare.document_compare(doc, doc))
+
+
+class Test_html_compare(unittest.TestCase):
+    'Testing amara.lib.treecompare.html_compare and html_diff'
+    def test_html(self):
+        self.assert_(treecompare.html_compare('<html><p>x<br></p></html>',
+                                              '<html><p>x<br></p></html>'))
+        diff = list(treecompare.document_diff(
+            '<html><p>x</p>\n<p>y</p></html>', '<html><p>x</p>\n<p>z</p></html>'))
+        self.assertEquals(diff[2:], [
+            '@@ event 7: expected line 2, compared line 2 @@',
+            " #text: u'\\n'",
+            ' start-tag: p',
+            "-#text: u'y'",
+            "+#text: u'z'",
+            ' end-tag: p',
+            ' end-tag: html',
+            ])
+
+    def test_trailing_text(self):
+        'The expected document ends with text the compared one continues'
+        self.failIf(treecompare.html_compare('<p>a</p>tail',
+                                             '<p>a</p>tail<b></b>'))
+        diff = list(treecompare.html_diff('<html><p>a</p>tail',
+                                          '<html><p>a</p>tail<b></b>'))
+        self.assertEquals(diff[:2], ['--- expected', '+++ compared'])
+        self.assert_('+start-tag: b' in diff)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -22,6 +22,19 @@ class Test_trim_word_count(unittest.TestCase):
             self.assertEquals(word_count, min(i, 9))
 
 
+class Test_readbysep(unittest.TestCase):
+    'Testing amara.lib.util.readbysep'
+    def test_records(self):
+        'Records split by separators, regardless of buffer size'
+        from cStringIO import StringIO
+        data = '\f'.join(['a', 'bb', '', 'c' * 50, 'd'])
+        for buffersize in (1, 2, 3, 7, 1000):
+            result = list(util.readbysep(StringIO(data), '\f', buffersize))
+            self.assertEquals(result, data.split('\f'))
+            result = list(util.readbysep(StringIO(data.replace('\f', '<->')), '<->', buffersize))
+            self.assertEquals(result, data.split('\f'))
+
+
 if __name__ == '__main__':
     raise SystemExit("Use nosetests (nosetests path/to/test/file)")
 
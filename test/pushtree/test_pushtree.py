@@ -3,7 +3,6 @@ from cStringIO import StringIO
 import amara
 from amara.pushtree import pushtree
 from amara.lib import treecompare
-from amara.test import KnownFailure
 
 XMLDECL = '<?xml version="1.0" encoding="UTF-8"?>\n'
 
@@ -173,8 +172,9 @@ class TestXPathMatcher(unittest.TestCase):
 
     def compare_matches(self, xpath):
         del self.results[:]
+        select = "|".join("//"+path for path in xpath.split("|"))
         select_ids = set(node.xml_attributes["x"]
-                                for node in TREEDOC.xml_select("//"+xpath))
+                                for node in TREEDOC.xml_select(select))
         pushtree(TREE1, xpath, self.callback)
         push_ids = set(self.results)
         self.assertEquals(select_ids, push_ids)
@@ -184,6 +184,20 @@ class TestXPathMatcher(unittest.TestCase):
         self.compare_matches("b")
         self.compare_matches("c")
 
+    def test_predicates(self):
+        for xpath in ("b[@x='4']", "*[@x='4']", "b[@x]", "c[@x!='3']",
+                      "*[@x>5]", "*['3'=@x]", "*[@x=9]", "*[@y]",
+                      "b[1]", "b[2]", "d[2]", "*[3]", "*[position()=2]",
+                      "*[position()<3]", "c[2]/c", "b/c[@x='3']/b[1]",
+                      "*[@x>4][2]", "c[1]|c[@x='10']|d", "b[2]|*[2]"):
+            self.compare_matches(xpath)
+
+    def test_unsupported_predicates(self):
+        self.assertRaises(NotImplementedError, pushtree, TREE1, "b[c]",
+                          self.callback)
+        self.assertRaises(NotImplementedError, pushtree, TREE1, "b[last()]",
+                          self.callback)
+
 
 def test_predicate1():
     EXPECTED = ['''<b x='4'>
@@ -194,14 +208,13 @@ def test_predicate1():
         <c x='9' />
       </b>''']
     results = []
-    raise KnownFailure("No predicates support.  See: http://trac.xml3k.org/ticket/23")
-
 
     def callback(node):
         results.append(node)
 
-    pushtree(TREE1, u"b[x='4']", callback)
+    pushtree(TREE1, u"b[@x='4']", callback)
 
+    assert len(results) == len(EXPECTED), results
     for result, expected in zip(results, EXPECTED):
         treecompare.check_xml(result.xml_encode(), XMLDECL+expected)
     return
@@ -222,6 +235,7 @@ def test_predicate2():
 
     pushtree(XML5, u"doc/one[2]", callback)
 
+    assert len(results) == len(EXPECTED), results
     for result, expected in zip(results, EXPECTED):
         treecompare.check_xml(result.xml_encode(), XMLDECL+expected)
     return
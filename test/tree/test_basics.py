@@ -93,6 +93,65 @@ class Test_attributes(unittest.TestCase):
         for k in [(None, 'g'), (None, 'h'), (None, 'z')]:
             self.assertFalse(k in attrs)
 
+class Test_children_arrays(unittest.TestCase):
+    def test_profile(self):
+        doc = parse('<a><b/><c>x</c><d><e/><f/><g/></d></a>')
+        profile = tree.children_profile(doc)
+        self.assertEqual(profile['containers'], 8)
+        self.assertEqual(profile['children'], 8)
+        # a and d need an array of their own, the rest fit inline
+        self.assertEqual(profile['heap_arrays'], 2)
+        self.assertEqual(profile['inline_arrays'], 6)
+        ptr = profile['allocated_bytes'] / (8 * 2 + 3 + 3)
+        self.assertEqual(profile['wasted_bytes'], (8 * 2 + 3 + 3 - 8) * ptr)
+
+    def test_grow_and_shrink(self):
+        e = tree.element(None, u'e')
+        kids = [ tree.text(unicode(i)) for i in range(5) ]
+        for k in kids:
+            e.xml_append(k)
+        self.assertEqual(tree.children_profile(e)['heap_arrays'], 1)
+        for k in kids[:3]:
+            e.xml_remove(k)
+        self.assertEqual(e.xml_children, tuple(kids[3:]))
+        self.assertEqual(tree.children_profile(e)['heap_arrays'], 0)
+        e.xml_insert(0, kids[0])
+        self.assertEqual(e.xml_children, (kids[0], kids[3], kids[4]))
+
+class Test_parse_records(unittest.TestCase):
+    """Testing tree.parse_records"""
+    def names(self, records):
+        return [ doc.xml_select(u'name(*)') for doc in records ]
+
+    def test_separators(self):
+        """Records separated by whitespace and separator characters"""
+        source = '<a>1</a>\f<b x="2"/>\f\f\n<c><d/></c>\f'
+        self.assertEqual(self.names(tree.parse_records(source, '\f')),
+                         [u'a', u'b', u'c'])
+        self.assertEqual(self.names(tree.parse_records('<a/><b/>\n<c/>')),
+                         [u'a', u'b', u'c'])
+        from cStringIO import StringIO
+        self.assertEqual(list(tree.parse_records(StringIO(' \n'))), [])
+
+    def test_records_match_parse(self):
+        """Each record parses the same as with parse()"""
+        from cStringIO import StringIO
+        records = [ '<?xml version="1.0"?>\n<r n="%d" xmlns="urn:x"><!--c-->%s</r>'
+                    % (i, 'text ' * (i * 100)) for i in xrange(50) ]
+        source = StringIO('\f'.join(records))
+        docs = list(tree.parse_records(source, '\f'))
+        self.assertEqual(len(docs), len(records))
+        for doc, record in zip(docs, records):
+            self.assertEqual(doc.xml_encode(), parse(record).xml_encode())
+
+    def test_error(self):
+        """A malformed record raises ReaderError"""
+        from amara import ReaderError
+        records = tree.parse_records('<a/>\f<b>\f<c/>', '\f')
+        self.assertEqual(records.next().xml_select(u'name(*)'), u'a')
+        self.assertRaises(ReaderError, records.next)
+        self.assertRaises(StopIteration, records.next)
+
 if __name__ == '__main__':
     raise SystemExit("use nosetests")
 
@@ -0,0 +1,118 @@
+# -*- encoding: utf-8 -*-
+# Testing binary tree images (amara.tree.dumps/loads)
+
+import os
+import struct
+import mmap
+import tempfile
+import unittest
+
+import amara
+from amara import tree
+
+XMLDECL = '<?xml version="1.0" encoding="UTF-8"?>\n'
+
+# deeper than the C stack would allow a recursive walk
+DEPTH = 100000
+
+TEST1 = '''<?xml-stylesheet href="style.xsl" type="text/xsl"?>
+<!--leading comment-->
+<a xmlns="urn:x-a" xmlns:b="urn:x-b" x="1" b:y="2">
+  <b:c xml:lang="en">text &amp; more text</b:c>
+  <d/><?pi data?><!--inner-->
+  <e>\xe2\x98\x83 snowman</e>
+</a>'''
+
+
+class Test_binary(unittest.TestCase):
+    def assertSameTree(self, a, b):
+        self.assertEqual(a.xml_encode(), b.xml_encode())
+
+    def test_roundtrip(self):
+        '''dumps/loads round trip of a parsed document'''
+        doc = amara.parse(TEST1, uri='http://example.com/doc.xml')
+        copied = tree.loads(tree.dumps(doc))
+        self.assertEqual(copied.xml_type, tree.entity.xml_type)
+        self.assertEqual(copied.xml_base, u'http://example.com/doc.xml')
+        self.assertSameTree(doc, copied)
+        return
+
+    def test_names_shared(self):
+        '''Names are restored as shared string objects'''
+        doc = tree.loads(tree.dumps(amara.parse('<a><b/><b/><b/></a>')))
+        b1, b2, b3 = doc.xml_first_child.xml_children
+        self.assert_(b1.xml_local is b2.xml_local is b3.xml_local)
+        return
+
+    def test_attributes_and_namespaces(self):
+        '''Attributes and namespace declarations survive a round trip'''
+        doc = tree.loads(tree.dumps(amara.parse(TEST1)))
+        a = doc.xml_select(u'*')[0]
+        self.assertEqual(a.xml_attributes[None, u'x'], u'1')
+        self.assertEqual(a.xml_attributes[u'urn:x-b', u'y'], u'2')
+        self.assertEqual(a.xml_namespaces[u'b'], u'urn:x-b')
+        return
+
+    def test_element(self):
+        '''dumps/loads of an element subtree'''
+        doc = amara.parse('<a><b x="1">i<c/>j</b></a>')
+        b = doc.xml_first_child.xml_first_child
+        copied = tree.loads(tree.dumps(b))
+        self.assertEqual(copied.xml_type, tree.element.xml_type)
+        self.assertEqual(copied.xml_parent, None)
+        self.assertEqual(copied.xml_encode(), b.xml_encode())
+        return
+
+    def test_mmap(self):
+        '''loads from a read-only memory map'''
+        doc = amara.parse(TEST1)
+        fd, path = tempfile.mkstemp()
+        try:
+            os.write(fd, tree.dumps(doc))
+            os.close(fd)
+            f = open(path, 'rb')
+            try:
+                image = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+                self.assertSameTree(doc, tree.loads(image))
+                image.close()
+            finally:
+                f.close()
+        finally:
+            os.remove(path)
+        return
+
+    def test_corrupt(self):
+        '''loads rejects truncated or foreign data'''
+        image = tree.dumps(amara.parse(TEST1))
+        self.assertRaises(ValueError, tree.loads, image[:-4])
+        self.assertRaises(ValueError, tree.loads, image[:40])
+        self.assertRaises(ValueError, tree.loads, XMLDECL + '<a/>')
+        # an attribute type out of range
+        image = tree.dumps(amara.parse('<a x="zzzz"/>'))
+        offset = image.index('zzzz') - 8
+        self.assertEqual(struct.unpack('=I', image[offset:offset+4]), (0,))
+        image = image[:offset] + struct.pack('=I', 99) + image[offset+4:]
+        self.assertRaises(ValueError, tree.loads, image)
+        return
+
+    def test_deep(self):
+        '''dumps/loads of a tree deeper than the C stack allows recursing'''
+        doc = tree.entity()
+        node = doc
+        for i in xrange(DEPTH):
+            node = node.xml_append(tree.element(None, u'x'))
+        node.xml_append(tree.text(u'leaf'))
+        copied = tree.loads(tree.dumps(doc))
+        for i in xrange(DEPTH):
+            copied = copied.xml_first_child
+        self.assertEqual(copied.xml_first_child.xml_value, u'leaf')
+        return
+
+    def test_bad_node(self):
+        '''dumps only accepts entities and elements'''
+        self.assertRaises(TypeError, tree.dumps, tree.text(u'x'))
+        return
+
+
+if __name__ == '__main__':
+    raise SystemExit("use nosetests")
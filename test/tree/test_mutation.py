@@ -85,6 +85,82 @@ def test_delns1():
     return
 
 
+def test_splice1():
+    EXPECTED = """<a><b/><x/><y/><e/></a>"""
+    doc = parse('<a><b/><c/><d/><e/></a>')
+    a = doc.xml_first_child
+    c, d = a.xml_children[1:3]
+    removed = a.xml_splice(1, 3, [tree.element(None, u'x'), tree.element(None, u'y')])
+    assert removed == (c, d)
+    assert c.xml_parent is None and d.xml_parent is None
+    assert [ n.xml_parent for n in a.xml_children ] == [a] * 4
+    treecompare.check_xml(doc.xml_encode(), XMLDECL+EXPECTED)
+    return
+
+def test_splice2():
+    #Nodes are moved from their previous parents, including this one
+    EXPECTED = """<a><d/><b/><x/><y/><c/></a>"""
+    doc = parse('<a><b/><c/><d/></a>')
+    other = parse('<z><x/><y/></z>').xml_first_child
+    a = doc.xml_first_child
+    b, c, d = a.xml_children
+    removed = a.xml_splice(1, 1, other.xml_children)
+    assert removed == ()
+    assert other.xml_children == ()
+    a.xml_splice(0, 0, [d])
+    treecompare.check_xml(doc.xml_encode(), XMLDECL+EXPECTED)
+    assert a.xml_splice(None, None, a.xml_children) == ()
+    treecompare.check_xml(doc.xml_encode(), XMLDECL+EXPECTED)
+    return
+
+def test_splice3():
+    doc = parse('<a><b/></a>')
+    a = doc.xml_first_child
+    b = a.xml_first_child
+    for bad in ([b, b], [a], [doc], [tree.attribute(None, u'x')]):
+        try:
+            b.xml_splice(0, 0, bad)
+        except ValueError:
+            pass
+        else:
+            raise AssertionError("xml_splice accepted %r" % (bad,))
+    try:
+        a.xml_splice(0, 0, [u'text'])
+    except TypeError:
+        pass
+    else:
+        raise AssertionError("xml_splice accepted a non-node")
+    assert a.xml_children == (b,)
+    #A failed splice leaves nodes taken from other parents where they were
+    other = parse('<z><x/><y/></z>').xml_first_child
+    x, y = other.xml_children
+    try:
+        b.xml_splice(0, 0, [x, y, a])
+    except ValueError:
+        pass
+    else:
+        raise AssertionError("xml_splice accepted an ancestor")
+    assert other.xml_children == (x, y)
+    assert x.xml_parent is other and y.xml_parent is other
+    return
+
+def test_splice_events():
+    events = []
+    class elem(tree.element):
+        def xml_children_spliced(self, removed, inserted):
+            events.append((removed, inserted))
+    a = elem(None, u'a')
+    b, c = tree.element(None, u'b'), tree.text(u'c')
+    a.xml_splice(0, 0, [b, c])
+    a.xml_splice(0, 1, [])
+    assert events == [((), (b, c)), ((b,), ())]
+    #The parents the nodes are taken from are told too
+    del events[:]
+    d = elem(None, u'd')
+    d.xml_splice(0, 0, [b, c])
+    assert events == [((c,), ()), ((), (b, c))]
+    return
+
 if __name__ == '__main__':
     raise SystemExit("use nosetests")
 
@@ -88,6 +88,88 @@ def test_coroutine_two_ply1():
     treecompare.check_xml(result, XMLDECL+EXPECTED)
     return
 
+#
+def test_feed_raw_and_generators():
+    EXPECTED = """<a xmlns:n="urn:bogus:n"><n:b n:c="1">x<r><s/></r>012</n:b></a>"""
+    NNS = u'urn:bogus:n'
+    output = structencoder()
+    output.feed(ROOT(E(u'a', NS(u'n', NNS), E((NNS, u'n:b'), {(NNS, u'n:c'): 1},
+        u'x', RAW(u'<r><s/></r>'), (unicode(i) for i in xrange(3))))))
+    result = output.read()
+    treecompare.check_xml(result, XMLDECL+EXPECTED)
+    return
+
+#
+def test_feed_raw_prolog():
+    #A leading XML declaration and doctype are not copied into the element
+    EXPECTED = """<a><r><s/></r></a>"""
+    output = structencoder()
+    output.feed(ROOT(E(u'a', RAW('<?xml version="1.0" encoding="utf-8"?>\n'
+                                 '<!DOCTYPE r [<!ELEMENT r ANY>]>\n<r><s/></r>'))))
+    result = output.read()
+    treecompare.check_xml(result, XMLDECL+EXPECTED)
+    return
+
+#
+def test_feed_raw_indented():
+    #Indented output reserializes RAW content so the rest stays indented
+    EXPECTED = """<?xml version="1.0" encoding="utf-8"?>
+<a>
+  <r>
+    <s/>
+  </r>
+  <b/>
+</a>"""
+    output = structencoder(indent=u'yes')
+    output.feed(ROOT(E(u'a', RAW('<?xml version="1.0" encoding="utf-8"?>\n'
+                                 '<r><s/></r>'), E(u'b'))))
+    result = output.read()
+    assert result == EXPECTED, result
+    return
+
+def test_feed_raw_entities():
+    #RAW content with a doctype is parsed, so its entities are expanded
+    EXPECTED = """<a><r>x</r></a>"""
+    output = structencoder()
+    output.feed(ROOT(E(u'a', RAW('<!DOCTYPE r [<!ENTITY e "x">]><r>&e;</r>'))))
+    result = output.read()
+    treecompare.check_xml(result, XMLDECL+EXPECTED)
+    return
+
+def test_feed_raw_fragment():
+    #RAW content is a fragment, whether or not the output is indented
+    for indent, EXPECTED in (
+        (False, '<a xmlns:n="urn:n"><r>a</r>junk<n:s/></a>'),
+        (True, '<a xmlns:n="urn:n">\n  <r>a</r>junk<n:s/>\n</a>')):
+        output = structencoder(indent=indent)
+        output.feed(ROOT(E(u'a', NS(u'n', u'urn:n'),
+                           RAW('<r>a</r>junk<n:s/>'))))
+        result = output.read()
+        assert result == '<?xml version="1.0" encoding="utf-8"?>\n' + EXPECTED, result
+    return
+
+#
+def test_feed_false_lead():
+    #An element whose first child is false is written empty
+    EXPECTED = """<a><b/><c xmlns:n="urn:n"/></a>"""
+    output = structencoder()
+    output.feed(ROOT(E(u'a', E(u'b', None, u'x'), E(u'c', NS(u'n', u'urn:n'), u'', E(u'd')))))
+    result = output.read()
+    treecompare.check_xml(result, XMLDECL+EXPECTED)
+    return
+
+#
+def test_feed_deep_nesting():
+    #Nesting deeper than the Python recursion limit
+    DEPTH = 5000
+    doc = E(u'x', u'leaf')
+    for i in xrange(DEPTH):
+        doc = E(u'x', doc)
+    output = structencoder()
+    output.feed(ROOT(doc))
+    result = output.read()
+    assert result.endswith('<x>' * DEPTH + '<x>leaf' + '</x>' * (DEPTH+1)), result[-200:]
+    return
 
 
 if __name__ == '__main__':
@@ -0,0 +1,72 @@
+# Testing parse-time whitespace stripping (PROPERTY_WHITESPACE_RULES)
+
+import unittest
+from cStringIO import StringIO
+
+from amara.lib import inputsource
+from amara.reader import saxreader, ContentHandler, PROPERTY_WHITESPACE_RULES
+
+DOC = '''<doc xmlns:x="urn:x">
+  <a> </a>
+  <b> </b>
+  <x:c> </x:c>
+  <x:d> </x:d>
+  <e xml:space="preserve"> </e>
+</doc>'''
+
+class text_collector(ContentHandler):
+    def __init__(self):
+        self.stack = []
+        self.texts = {}
+    def startElementNS(self, name, qname, attribs):
+        self.stack.append(name[1])
+    def endElementNS(self, name, qname):
+        self.stack.pop()
+    def characters(self, data):
+        if self.stack:
+            self.texts.setdefault(self.stack[-1], []).append(data)
+
+def parse_with_rules(rules):
+    handler = text_collector()
+    reader = saxreader()
+    reader.setContentHandler(handler)
+    reader.setProperty(PROPERTY_WHITESPACE_RULES, rules)
+    reader.parse(inputsource(DOC, 'urn:x-test'))
+    return sorted([ k for k in handler.texts if k != u'doc' ])
+
+
+class Test_whitespace_rules(unittest.TestCase):
+    def test_no_rules(self):
+        self.assertEqual([u'a', u'b', u'c', u'd', u'e'], parse_with_rules([]))
+
+    def test_expanded_names(self):
+        rules = [(None, u'a', True), (u'urn:x', u'c', True)]
+        self.assertEqual([u'b', u'd', u'e'], parse_with_rules(rules))
+
+    def test_namespace_wildcard(self):
+        rules = [(u'urn:x', u'*', True)]
+        self.assertEqual([u'a', u'b', u'e'], parse_with_rules(rules))
+
+    def test_precedence(self):
+        # the first matching rule wins
+        rules = [(None, u'b', False), (u'urn:x', u'd', False),
+                 (u'urn:x', u'*', True), (None, u'*', True)]
+        self.assertEqual([u'b', u'd', u'e'], parse_with_rules(rules))
+        rules = [(None, u'*', True), (None, u'b', False)]
+        self.assertEqual([u'e'], parse_with_rules(rules))
+
+    def test_many_rules(self):
+        rules = [ (None, u'n%d' % i, True) for i in xrange(500) ]
+        rules.append((None, u'b', True))
+        self.assertEqual([u'a', u'c', u'd', u'e'], parse_with_rules(rules))
+
+    def test_roundtrip(self):
+        rules = ((None, u'a', True), (u'urn:x', u'*', False),
+                 (None, u'*', True))
+        reader = saxreader()
+        reader.setProperty(PROPERTY_WHITESPACE_RULES, rules)
+        self.assertEqual(rules, reader.getProperty(PROPERTY_WHITESPACE_RULES))
+
+
+if __name__ == '__main__':
+    raise SystemExit("use nosetests")
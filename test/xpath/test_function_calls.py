@@ -166,6 +166,10 @@ def test_substring_function():
         ([string_literal('"12345"'), number_literal('1'), NOT_A_NUMBER],  datatypes.string('')),
         ([string_literal('"12345"'), number_literal('-42'), POSITIVE_INFINITY],  datatypes.string('12345')),
         ([string_literal('"12345"'), NEGATIVE_INFINITY, POSITIVE_INFINITY],  datatypes.string('')),
+        ([string_literal('"12345"'), number_literal('-1'), number_literal('3')],  datatypes.string('1')),
+        ([string_literal('"12345"'), number_literal('2.5'), number_literal('100')],  datatypes.string('345')),
+        ([string_literal('"12345"'), number_literal('3'), NEGATIVE_INFINITY],  datatypes.string('')),
+        ([string_literal('"12345"'), number_literal('6')],  datatypes.string('')),
         ):
         result = function_call('substring', args).evaluate_as_string(CONTEXT1)
         assert isinstance(result, datatypes.string)
@@ -183,6 +187,11 @@ def test_normalize_space_function():
     assert isinstance(result, datatypes.string)
     expected = datatypes.string(u'Ht There Mike')
     assert result == expected, (result, expected)
+    # only XML whitespace is normalized; NO-BREAK SPACE is kept
+    result = function_call('normalize-space',
+                           [string_literal(u'" \r\n a\u00a0 b "')]).evaluate_as_string(CONTEXT1)
+    expected = datatypes.string(u'a\u00a0 b')
+    assert result == expected, (result, expected)
 
 def test_translate_function():
     for args, expected in ( 
@@ -210,10 +219,17 @@ def test_translate_function():
         # in the 3rd arg, that char is removed from the 1st arg
         ([string_literal('"hello world"'), string_literal('abcdefgh'), string_literal('')],
          datatypes.string('llo worl')),
+
+        # characters outside the BMP are translated as well
+        ([string_literal(u'"a\U00010400b"'), string_literal(u'"\U00010400b"'), string_literal('"x"')],
+         datatypes.string(u'ax')),
         ):
         result = function_call('translate', args).evaluate_as_string(CONTEXT1)
         assert isinstance(result, datatypes.string)
         assert result == expected, (result, expected)
+        # a second evaluation reuses the cached translation table
+        result = function_call('translate', args).evaluate_as_string(CONTEXT1)
+        assert result == expected, (result, expected)
 
 def test_boolean_function():
     result = function_call('boolean', [string_literal('"3.14Hi"')]).evaluate_as_boolean(CONTEXT1)
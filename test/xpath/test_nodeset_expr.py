@@ -8,7 +8,7 @@ from test_expressions import (
     # boolean literals
     TRUE, FALSE,
     # nodeset literals
-    nodeset_literal, ROOT, CHILD1, CHILD2, CHILD3
+    nodeset_literal, ROOT, CHILD1, CHILD2, CHILD3, ATTR1
     )
 
 CONTEXT = context(CHILD1, 1, 1)
@@ -41,5 +41,16 @@ def test_filter_exr():
                          ).evaluate_as_nodeset(CONTEXT)
     _check_nodeset_result(result, datatypes.nodeset())
 
+
+def test_nodeset_document_order():
+    # siblings already in document order are accepted as-is
+    _check_nodeset_result(datatypes.nodeset([CHILD1, CHILD2, CHILD3]),
+                          [CHILD1, CHILD2, CHILD3])
+    # everything else is still sorted
+    _check_nodeset_result(datatypes.nodeset([CHILD3, CHILD1, CHILD2]),
+                          [CHILD1, CHILD2, CHILD3])
+    _check_nodeset_result(datatypes.nodeset([CHILD2, ATTR1, ROOT]),
+                          [ROOT, ATTR1, CHILD2])
+
 if __name__ == '__main__':
     raise SystemExit("use nosetests")
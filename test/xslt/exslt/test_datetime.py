@@ -0,0 +1,76 @@
+########################################################################
+# test/xslt/exslt/test_datetime.py
+import cStringIO
+import unittest
+
+from amara.test import test_main
+
+TRANSFORM = """<?xml version="1.0"?>
+<xsl:stylesheet version="1.0"
+  xmlns:xsl="http://www.w3.org/1999/XSL/Transform"
+  xmlns:date="http://exslt.org/dates-and-times"
+  >
+  <xsl:output method="text"/>
+  <xsl:template match="/">%s</xsl:template>
+</xsl:stylesheet>
+"""
+
+class test_datetime(unittest.TestCase):
+    source = "<doc><d>2009-04-01T13:05:09.25-05:00</d><d>2008-12-31</d></doc>"
+
+    def _transform(self, body):
+        from amara.xslt import transform
+        io = cStringIO.StringIO()
+        transform(self.source, TRANSFORM % body, output=io)
+        return io.getvalue()
+
+    def test_fields(self):
+        result = self._transform("""<xsl:for-each select="doc/d"
+          ><xsl:value-of select="date:date(.)"/>|<xsl:value-of
+          select="date:year(.)"/>|<xsl:value-of
+          select="date:month-name(.)"/>|<xsl:value-of
+          select="date:day-in-year(.)"/>|<xsl:value-of
+          select="date:week-in-year(.)"/>|<xsl:value-of
+          select="date:day-abbreviation(.)"/>;</xsl:for-each><xsl:value-of
+          select="date:year('bogus')"/>""")
+        self.assertEqual(result, "2009-04-01-05:00|2009|April|91|14|Wed;"
+                                 "2008-12-31|2008|December|366|1|Wed;NaN")
+        return
+
+    def test_format_date(self):
+        result = self._transform("""<xsl:for-each select="doc/d"
+          ><xsl:value-of select="date:format-date(.,
+            &quot;EEEE, d MMM yyyy 'at' hh:mm a z ''&quot;)"/>;</xsl:for-each
+          ><xsl:value-of select="date:format-date('2009-04', 'MMMM yy')"/>""")
+        self.assertEqual(result, "Wednesday, 1 Apr 2009 at 01:05 PM -05:00 ';"
+                                 "Wednesday, 31 Dec 2008 at 12:00 AM  ';"
+                                 "April 09")
+        return
+
+    def test_durations(self):
+        result = self._transform("""<xsl:value-of
+          select="date:difference('2009-01-01', '2009-03-01')"/>|<xsl:value-of
+          select="date:add('2009-01-15', 'P1M')"/>|<xsl:value-of
+          select="date:add-duration('P1D', 'PT36H')"/>|<xsl:value-of
+          select="date:seconds('PT1H1.5S')"/>|<xsl:value-of
+          select="date:duration(3661)"/>|<xsl:value-of
+          select="date:seconds('PT')"/>""")
+        self.assertEqual(result, "P59D|2009-02-15|P2DT12H|3601.5|PT1H1M1S|NaN")
+        return
+
+    def test_parse(self):
+        from amara.xslt.exslt._iso8601 import parse_datetime, parse_duration
+        self.assertEqual(parse_datetime(u'-0044-03-15Z', ('gYear', 'date')),
+                         (-44, 3, 15, None, None, None, u'Z'))
+        self.assertEqual(parse_datetime(u'--12', ('gDay', 'gMonth')),
+                         (None, 12, None, None, None, None, None))
+        self.assertRaises(ValueError, parse_datetime, u'2009-4-01', ('date',))
+        self.assertEqual(parse_duration(u'-P1Y2M3DT4H5M6.5S'),
+                         (True, 1, 2, 3, 4, 5, 6.5))
+        for invalid in (u'PT', u'P1H', u'P1D1M', u'PT1.5M', u'P1Y1Y'):
+            self.assertRaises(ValueError, parse_duration, invalid)
+        return
+
+
+if __name__ == '__main__':
+    test_main()
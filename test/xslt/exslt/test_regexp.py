@@ -0,0 +1,62 @@
+########################################################################
+# test/xslt/exslt/test_regexp.py
+import cStringIO
+import unittest
+
+from amara.test import test_main
+
+TRANSFORM = """<?xml version="1.0"?>
+<xsl:stylesheet version="1.0"
+  xmlns:xsl="http://www.w3.org/1999/XSL/Transform"
+  xmlns:regexp="http://exslt.org/regular-expressions"
+  >
+  <xsl:output method="text"/>
+  <xsl:template match="/">%s</xsl:template>
+</xsl:stylesheet>
+"""
+
+class test_regexp(unittest.TestCase):
+    source = "<doc>2009-04-01 ERROR disk full</doc>"
+
+    def _transform(self, body):
+        from amara.xslt import transform
+        io = cStringIO.StringIO()
+        transform(self.source, TRANSFORM % body, output=io)
+        return io.getvalue()
+
+    def test_match(self):
+        result = self._transform("""<xsl:for-each
+          select="regexp:match(doc, '(\\d+)-(\\d+)-(x)?(\\d+)')"
+          >[<xsl:value-of select="."/>]</xsl:for-each>""")
+        self.assertEqual(result, "[2009-04-01][2009][04][][01]")
+        return
+
+    def test_match_global(self):
+        result = self._transform("""<xsl:for-each
+          select="regexp:match(doc, '[a-z]+', 'gi')"
+          >[<xsl:value-of select="."/>]</xsl:for-each>""")
+        self.assertEqual(result, "[ERROR][disk][full]")
+        return
+
+    def test_match_nodes(self):
+        result = self._transform("""<xsl:for-each
+          select="regexp:match(doc, 'nomatch|(\\d+)')"
+          ><xsl:value-of select="concat(name(), count(../*), ' ')"
+          /></xsl:for-each><xsl:value-of
+          select="count(regexp:match(doc, 'nomatch'))"/>""")
+        self.assertEqual(result, "match2 match2 0")
+        return
+
+    def test_replace_and_test(self):
+        result = self._transform("""<xsl:value-of
+          select="regexp:replace(doc, '\\d', 'g', '#')"/>|<xsl:value-of
+          select="regexp:replace(doc, 'error', 'i', 'WARN')"/>|<xsl:value-of
+          select="regexp:test(doc, 'error')"/>|<xsl:value-of
+          select="regexp:test(doc, 'error', 'i')"/>""")
+        self.assertEqual(result, "####-##-## ERROR disk full|"
+                                 "2009-04-01 WARN disk full|false|true")
+        return
+
+
+if __name__ == '__main__':
+    test_main()
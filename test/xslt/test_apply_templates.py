@@ -222,6 +222,29 @@ def test_apply_templates_9():
     expected = """<?xml version="1.0" encoding="UTF-8"?>
 <docelem>""" + "1a"*5 + "1c"*5 + "</docelem>")
 
+def test_apply_templates_10():
+    """`xsl:apply-templates` matching predicated patterns"""
+    _run_xml(
+        source_xml = SOURCE_XML,
+        transform_xml = """<?xml version="1.0"?>
+<xsl:stylesheet xmlns:xsl="http://www.w3.org/1999/XSL/Transform" version="1.0">
+  <xsl:template match='/'>
+    <docelem>
+      <xsl:apply-templates/>
+    </docelem>
+  </xsl:template>
+  <xsl:template match='text()'/>
+  <xsl:template match='item'>
+    <xsl:value-of select='.'/>
+  </xsl:template>
+  <xsl:template match='item[1]'>[1]</xsl:template>
+  <xsl:template match='item[position() mod 4 = 0]'>{<xsl:value-of select='.'/>}</xsl:template>
+  <xsl:template match='item[@in][3]'>(<xsl:value-of select='.'/>)</xsl:template>
+</xsl:stylesheet>
+""",
+        expected = """<?xml version="1.0" encoding="UTF-8"?>
+<docelem>[1]ad{c}b(a)d{c}""" + "bad{c}"*3 + "</docelem>")
+
 def test_apply_templates_error_1():
     """xsl:apply-templates with invalid select expression"""
     try:
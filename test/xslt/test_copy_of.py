@@ -58,6 +58,35 @@ def test_copy_of_2():
   <path d="M500,600 C500,500 650,500 650,600                             S800,700 800,600" class="ViaAppia"/>
 </svg>""")
 
+def test_copy_of_3():
+    """copy into a result tree fragment"""
+    _run_xml(
+        source_xml = """<?xml version="1.0"?>
+<doc xmlns:x="urn:x"><?pi data?><x:a b="1" x:c="2">one<!--note-->two<e/></x:a>three</doc>""",
+        transform_xml = """<?xml version="1.0"?>
+<xsl:stylesheet version="1.0"
+  xmlns:xsl="http://www.w3.org/1999/XSL/Transform"
+  xmlns:exsl="http://exslt.org/common"
+  exclude-result-prefixes="exsl"
+  >
+<xsl:template match="/">
+  <xsl:variable name="rtf">
+    <xsl:text>[</xsl:text>
+    <xsl:copy-of select="doc/node()"/>
+    <xsl:copy-of select="doc/text()"/>
+    <xsl:text disable-output-escaping="yes">&lt;raw/&gt;</xsl:text>
+  </xsl:variable>
+  <result>
+    <xsl:copy-of select="$rtf"/>
+    <count><xsl:value-of select="count(exsl:node-set($rtf)/node())"/></count>
+  </result>
+</xsl:template>
+</xsl:stylesheet>
+""",
+        expected = """<?xml version="1.0" encoding="UTF-8"?>
+<result>[<?pi data?><x:a xmlns:x="urn:x" b="1" x:c="2">one<!--note-->two<e/></x:a>threethree<raw/><count>5</count></result>"""
+        )
+
 # XXX This was in the older tests, but it doesn't seem to be used for anything. ??
 if 0:
     expected_offline = """<?xml version="1.0" encoding="UTF-8"?>
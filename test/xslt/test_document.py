@@ -0,0 +1,81 @@
+########################################################################
+# test/xslt/test_document.py
+import os
+import tempfile
+
+from amara.lib import inputsource, iri
+from amara.xpath import util
+from amara.xslt.processor import processor, document_cache
+
+TRANSFORM = """<?xml version="1.0"?>
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform">
+  <xsl:output method="text"/>
+  <xsl:param name="lookup"/>
+  <xsl:template match="/">
+    <xsl:value-of select="document($lookup)/table/@v"/>
+  </xsl:template>
+</xsl:stylesheet>"""
+
+
+def _write(path, value):
+    f = open(path, 'w')
+    try:
+        f.write('<table v="%s"/>' % value)
+    finally:
+        f.close()
+
+
+def test_document_cache():
+    """document() with a document cache shared between runs"""
+    fd, path = tempfile.mkstemp('.xml')
+    os.close(fd)
+    try:
+        uri = iri.os_path_to_uri(path)
+        _write(path, 'one')
+        cache = document_cache()
+        P = processor(document_cache=cache)
+        P.append_transform(inputsource(TRANSFORM, 'urn:x-transform'))
+        parameters = util.parameterize({'lookup': uri})
+        def run():
+            return str(P.run(inputsource('<dummy/>', 'urn:x-source'),
+                             parameters=parameters))
+        assert run() == 'one'
+        assert uri in cache
+        doc = cache.fetch(uri)
+        assert run() == 'one'
+        assert cache.fetch(uri) is doc
+        # a changed file is parsed again
+        _write(path, 'second')
+        assert run() == 'second'
+        assert cache.fetch(uri) is not doc
+        assert len(cache) == 1
+        cache.clear()
+        assert len(cache) == 0
+    finally:
+        os.remove(path)
+
+
+def test_document_cache_bounded():
+    """document cache discards the least recently used documents"""
+    cache = document_cache(max_entries=2)
+    paths = []
+    try:
+        for value in ('a', 'b', 'c'):
+            fd, path = tempfile.mkstemp('.xml')
+            os.close(fd)
+            _write(path, value)
+            paths.append(iri.os_path_to_uri(path))
+        first = cache.fetch(paths[0])
+        cache.fetch(paths[1])
+        cache.fetch(paths[0])
+        cache.fetch(paths[2])
+        assert len(cache) == 2
+        assert paths[1] not in cache
+        assert cache.fetch(paths[0]) is first
+    finally:
+        for uri in paths:
+            os.remove(iri.uri_to_os_path(uri))
+
+
+if __name__ == '__main__':
+    raise SystemExit("use nosetests")
@@ -49,5 +49,40 @@ def test_literals_2():
         expected = """<?xml version='1.0' encoding='us-ascii'?>
 <result><text/><value/></result>""")
 
+def test_literals_3():
+    """literal result elements with constant and dynamic attributes"""
+    _run_xml(
+        source_xml = """<?xml version="1.0"?><doc id="d1"><item n="1"/><item n="2"/></doc>""",
+        transform_xml = """<?xml version="1.0"?>
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform"
+  xmlns:x="http://example.com/x">
+
+  <xsl:attribute-set name="static">
+    <xsl:attribute name="class">row</xsl:attribute>
+    <xsl:attribute name="x:kind">item</xsl:attribute>
+  </xsl:attribute-set>
+
+  <xsl:attribute-set name="override">
+    <xsl:attribute name="class">main</xsl:attribute>
+  </xsl:attribute-set>
+
+  <xsl:attribute-set name="dynamic" use-attribute-sets="static">
+    <xsl:attribute name="pos"><xsl:value-of select="position()"/></xsl:attribute>
+  </xsl:attribute-set>
+
+  <xsl:template match="doc">
+    <table id="{@id}" border="0" xsl:use-attribute-sets="static override">
+      <xsl:for-each select="item">
+        <tr n="{@n}" xsl:use-attribute-sets="dynamic"/>
+        <td class="cell" x:kind="{@n}"/>
+      </xsl:for-each>
+    </table>
+  </xsl:template>
+
+</xsl:stylesheet>
+""",
+        expected = """<?xml version='1.0' encoding='UTF-8'?>
+<table id='d1' border='0' class='main' x:kind='item' xmlns:x='http://example.com/x'><tr n='1' class='row' x:kind='item' pos='1'/><td class='cell' x:kind='1'/><tr n='2' class='row' x:kind='item' pos='2'/><td class='cell' x:kind='2'/></table>""")
+
 if __name__ == '__main__':
     raise SystemExit("use nosetests")
@@ -0,0 +1,95 @@
+########################################################################
+# test/xslt/test_number.py
+
+from xslt_support import _run_text
+
+SOURCE = """<?xml version="1.0"?>
+<doc>
+  <chapter>
+    <title>A</title>
+    <section><title>A.1</title><note/></section>
+    <section><title>A.2</title><note/><note/></section>
+  </chapter>
+  <appendix/>
+  <chapter>
+    <title>B</title>
+    <section><title>B.1</title><note/></section>
+  </chapter>
+</doc>"""
+
+TRANSFORM = """<?xml version="1.0"?>
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform">
+  <xsl:output method="text"/>
+  <xsl:template match="/">
+    <xsl:for-each select="%s">
+      %s
+      <xsl:text> </xsl:text>
+    </xsl:for-each>
+  </xsl:template>
+</xsl:stylesheet>"""
+
+
+def _run_number(select, number, expected):
+    _run_text(source_xml=SOURCE,
+              transform_xml=TRANSFORM % (select, number),
+              expected=expected)
+
+
+def test_number_single():
+    """`xsl:number` level="single" """
+    _run_number('//section', '<xsl:number/>', "1 2 1 ")
+    _run_number('//title', '<xsl:number count="chapter|section"/>',
+                "1 1 2 2 1 ")
+    # numbering out of document order must give the same values
+    _run_number('//section|//chapter',
+                '<xsl:sort select="count(ancestor::*)" order="descending"/>'
+                '<xsl:number count="section|chapter"/>',
+                "1 2 1 1 2 ")
+
+
+def test_number_multiple():
+    """`xsl:number` level="multiple" """
+    _run_number('//note',
+                '<xsl:number level="multiple" count="chapter|section|note"'
+                ' format="1.1"/>',
+                "1.1.1 1.2.1 1.2.2 2.1.1 ")
+    _run_number('//note',
+                '<xsl:number level="multiple" from="chapter"'
+                ' count="section|note" format="1.1"/>',
+                "1.1 2.1 2.2 1.1 ")
+
+
+def test_number_any():
+    """`xsl:number` level="any" """
+    _run_number('//note', '<xsl:number level="any"/>', "1 2 3 4 ")
+    _run_number('//note', '<xsl:number level="any" from="chapter"/>',
+                "1 2 3 1 ")
+    _run_number('//note[position() mod 2 = 0]|//title',
+                '<xsl:sort select="." order="descending"/>'
+                '<xsl:number level="any" count="note|title"/>',
+                "8 7 4 2 1 6 ")
+
+
+def test_number_variable_pattern():
+    """`xsl:number` with patterns depending on a variable"""
+    source = """<?xml version="1.0"?>
+<doc><i t="a"/><i t="b"/><i t="a"/><i t="b"/><i t="b"/></doc>"""
+    transform = """<?xml version="1.0"?>
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform">
+  <xsl:output method="text"/>
+  <xsl:template match="doc">
+    <xsl:for-each select="i">
+      <xsl:variable name="t" select="@t"/>
+      <xsl:number %s count="i[@t=$t]"/>
+      <xsl:text> </xsl:text>
+    </xsl:for-each>
+  </xsl:template>
+</xsl:stylesheet>"""
+    _run_text(source_xml=source, transform_xml=transform % '',
+              expected="1 1 2 2 3 ")
+    _run_text(source_xml=source, transform_xml=transform % 'level="any"',
+              expected="1 1 2 2 3 ")
+
+
+if __name__ == '__main__':
+    raise SystemExit("use nosetests")
@@ -0,0 +1,79 @@
+########################################################################
+# test/xslt/test_sort.py
+
+from xslt_support import _run_text
+
+SOURCE = """<?xml version="1.0"?>
+<doc>
+  <item n="3" s="b">one</item>
+  <item n="x" s="B">two</item>
+  <item n="-1" s="a">three</item>
+  <item n="10" s="A">four</item>
+  <item n="3" s="a">five</item>
+  <item n="NaN" s="c">six</item>
+</doc>"""
+
+TRANSFORM = """<?xml version="1.0"?>
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform">
+  <xsl:output method="text"/>
+  <xsl:template match="doc">
+    <xsl:for-each select="item">
+      %s
+      <xsl:value-of select="."/>
+      <xsl:text> </xsl:text>
+    </xsl:for-each>
+  </xsl:template>
+</xsl:stylesheet>"""
+
+
+def _run_sort(sort, expected):
+    _run_text(source_xml=SOURCE,
+             transform_xml=TRANSFORM % sort,
+             expected=expected)
+
+
+def test_sort_text():
+    """`xsl:sort` text ascending and descending"""
+    _run_sort('<xsl:sort select="@s"/>',
+              "four two three five one six ")
+    _run_sort('<xsl:sort select="@s" order="descending"/>',
+              "six one three five two four ")
+
+
+def test_sort_number():
+    """`xsl:sort` numbers with NaN ordering"""
+    _run_sort('<xsl:sort select="@n" data-type="number"/>',
+              "two six three one five four ")
+    _run_sort('<xsl:sort select="@n" data-type="number" order="descending"/>',
+              "four one five three two six ")
+
+
+def test_sort_case_order():
+    """`xsl:sort` case-order"""
+    _run_sort('<xsl:sort select="translate(@s, \'bBc\', \'aAa\')"'
+              ' case-order="lower-first"/>',
+              "one three five six two four ")
+    _run_sort('<xsl:sort select="translate(@s, \'bBc\', \'aAa\')"'
+              ' case-order="upper-first" order="descending"/>',
+              "one three five six two four ")
+
+
+def test_sort_multiple_keys():
+    """`xsl:sort` with mixed keys and orders"""
+    _run_sort('<xsl:sort select="@n" data-type="number" order="descending"/>'
+              '<xsl:sort select="@s"/>',
+              "four five one three two six ")
+    _run_sort('<xsl:sort select="translate(@s, \'AB\', \'ab\')"/>'
+              '<xsl:sort select="@n" data-type="number" order="descending"/>',
+              "four five three one two six ")
+
+
+def test_sort_avt():
+    """`xsl:sort` with attribute value templates"""
+    _run_sort('<xsl:sort select="@n" data-type="{\'number\'}"'
+              ' order="{\'descending\'}"/>',
+              "four one five three two six ")
+
+
+if __name__ == '__main__':
+    raise SystemExit("use nosetests")
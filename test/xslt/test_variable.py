@@ -0,0 +1,62 @@
+########################################################################
+# test/xslt/test_variable.py
+
+from xslt_support import _run_text
+
+SOURCE = """<?xml version="1.0"?><doc><a>alpha</a><b>2</b></doc>"""
+
+
+def test_variable_text_only():
+    """`xsl:variable` with a text-only body"""
+    _run_text(
+        source_xml = SOURCE,
+        transform_xml = """<?xml version="1.0"?>
+<xsl:stylesheet version="1.0"
+  xmlns:xsl="http://www.w3.org/1999/XSL/Transform"
+  xmlns:exsl="http://exslt.org/common"
+  >
+  <xsl:output method="text"/>
+  <xsl:template match="/doc">
+    <xsl:variable name="v">[<xsl:value-of select="a"/>]<xsl:text>!</xsl:text></xsl:variable>
+    <xsl:variable name="n"><xsl:value-of select="b"/></xsl:variable>
+    <xsl:variable name="empty"><xsl:value-of select="nothing"/></xsl:variable>
+    <xsl:value-of select="$v"/>
+    <xsl:text>|</xsl:text>
+    <xsl:value-of select="$n * 2"/>
+    <xsl:text>|</xsl:text>
+    <!-- a result tree fragment is always true, even without content -->
+    <xsl:if test="$empty">true</xsl:if>
+    <xsl:text>|</xsl:text>
+    <xsl:value-of select="count(exsl:node-set($v)/node())"/>
+    <xsl:value-of select="count(exsl:node-set($empty)/node())"/>
+    <xsl:value-of select="exsl:object-type($v)"/>
+  </xsl:template>
+</xsl:stylesheet>
+""",
+        expected = "[alpha]!|4|true|10RTF")
+
+
+def test_variable_tree():
+    """`xsl:variable` with a body producing elements"""
+    _run_text(
+        source_xml = SOURCE,
+        transform_xml = """<?xml version="1.0"?>
+<xsl:stylesheet version="1.0"
+  xmlns:xsl="http://www.w3.org/1999/XSL/Transform"
+  xmlns:exsl="http://exslt.org/common"
+  >
+  <xsl:output method="text"/>
+  <xsl:template match="/doc">
+    <xsl:variable name="v">x<item><xsl:value-of select="a"/></item>y</xsl:variable>
+    <xsl:value-of select="$v"/>
+    <xsl:text>|</xsl:text>
+    <xsl:value-of select="count(exsl:node-set($v)/node())"/>
+    <xsl:value-of select="exsl:node-set($v)/item"/>
+  </xsl:template>
+</xsl:stylesheet>
+""",
+        expected = "xalphay|3alpha")
+
+
+if __name__ == '__main__':
+    raise SystemExit("use nosetests")
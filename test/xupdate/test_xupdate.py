@@ -383,6 +383,33 @@ class test_rename(test_xupdate):
 </my:info>
 """
 
+class test_multiple_targets(unittest.TestCase):
+    """commands selecting many nodes of the same parent"""
+    source = "<list>%s</list>" % ''.join(
+        '<i n="%d"/>' % n for n in range(1, 7))
+    xupdate = """<?xml version="1.0"?>
+<xupdate:modifications
+  version="1.0"
+  xmlns:xupdate="http://www.xmldb.org/xupdate"
+>
+  <xupdate:insert-before select="/list/i[@n mod 2 = 1]"><a/></xupdate:insert-before>
+  <xupdate:insert-after select="/list/i[@n mod 3 = 0]"><b/>t</xupdate:insert-after>
+  <xupdate:remove select="/list/i[@n > 4]"/>
+  <xupdate:rename select="/list/a">c</xupdate:rename>
+  <xupdate:update select="/list/text()"></xupdate:update>
+</xupdate:modifications>
+"""
+    expected = ('<list><c/><i n="1"/><i n="2"/><c/><i n="3"/><b/><i n="4"/>'
+                '<c/><b/></list>')
+
+    def test_result(self):
+        source = inputsource(self.source, 'source')
+        xupdate = inputsource(self.xupdate, 'xupdate-source')
+        document = apply_xupdate(source, xupdate)
+        result = document.xml_encode().split('?>', 1)[-1].strip()
+        self.assertEquals(self.expected, result)
+        return
+
 #-----------------------------------------------------------------------
 
 class test_xupdate_error(unittest.TestCase):